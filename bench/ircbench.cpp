@@ -0,0 +1,1013 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <climits>
+#include <unistd.h>
+#include <fcntl.h>
+#include <csignal>
+#include <poll.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+/**
+ * @file ircbench.cpp
+ * @brief Loopback load generator for ircserv: starts the server binary it is given,
+ * drives it through real sockets and reads its CPU time from /proc.
+ *
+ * @details Any build of the server can be measured, so a change is benchmarked by
+ * running the same scenario against the binary built before it and after it.
+ * Usage: ircbench <scenario> <binary> <port> [arguments] [-- server options]
+ */
+
+#define BENCH_PASSWORD "benchpw"
+#define BENCH_TIMEOUT 10.0 //seconds a reply may take before the scenario gives up
+#define SCALING_WINDOW 32 //messages each sender of the scaling scenario keeps in flight
+#define MALLOC_BATCH 200 //command lines sent by the mallocs scenario before it waits for the server
+#define JOIN_BATCH 100 //clients joined to a channel before their sockets are drained
+#define FANOUT_BATCH 20 //channel messages sent by the fanout scenario before it waits for every member
+#define FANOUT_PAYLOAD 400 //text bytes of each channel message of the fanout scenario (the line stays under 512)
+
+/******************/
+/*    Plumbing    */
+/******************/
+
+static double now()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static pid_t g_server = 0; //server started by startServer(), killed by fail()
+
+static void fail(const std::string &reason)
+{
+	std::cerr << "ircbench: " << reason << std::endl;
+	if (g_server > 0)
+	{
+		kill(g_server, SIGKILL);
+		waitpid(g_server, NULL, 0);
+	}
+	exit(1);
+}
+
+/**
+ * @brief CPU time (user + system, all threads) a process used so far.
+ * @param userOnly True to leave the system time out (what the server spends in its own code)
+ * @note Read from /proc/<pid>/stat, in clock ticks: measure long enough runs (seconds)
+ */
+static double cpuSeconds(pid_t pid, bool userOnly = false)
+{
+	std::ostringstream path;
+	path << "/proc/" << pid << "/stat";
+	FILE *file = fopen(path.str().c_str(), "r");
+	if (!file)
+		fail("cannot read " + path.str());
+	char buffer[1024];
+	size_t length = fread(buffer, 1, sizeof(buffer) - 1, file);
+	fclose(file);
+	buffer[length] = '\0';
+	const char *field = strrchr(buffer, ')'); //the command name may contain spaces
+	unsigned long utime = 0, stime = 0;
+	if (!field || sscanf(field + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &utime, &stime) != 2)
+		fail("cannot parse " + path.str());
+	return static_cast<double>(userOnly ? utime : utime + stime) / sysconf(_SC_CLK_TCK);
+}
+
+static int connectTo(int port, bool wait)
+{
+	double deadline = now() + BENCH_TIMEOUT;
+	while (true)
+	{
+		int fd = socket(AF_INET, SOCK_STREAM, 0);
+		if (fd < 0)
+			fail(std::string("socket(): ") + strerror(errno));
+		struct sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_port = htons(port);
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0)
+		{
+			int enable = 1;
+			setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+			return fd;
+		}
+		close(fd);
+		if (!wait || now() > deadline)
+			fail(std::string("connect(): ") + strerror(errno));
+		usleep(20000);
+	}
+}
+
+static void sendAll(int fd, const std::string &data)
+{
+	size_t done = 0;
+	while (done < data.size())
+	{
+		ssize_t sent = send(fd, data.data() + done, data.size() - done, MSG_NOSIGNAL);
+		if (sent < 0 && errno == EINTR)
+			continue;
+		if (sent <= 0)
+			fail(std::string("send(): ") + strerror(errno));
+		done += sent;
+	}
+}
+
+/**
+ * @brief Reads until the received bytes hold count occurrences of token.
+ * @param pending Bytes received earlier and not consumed yet, consumed up to the last match
+ * @return size_t Occurrences found (count, unless the server went quiet for BENCH_TIMEOUT)
+ */
+static size_t expect(int fd, std::string &pending, const std::string &token, size_t count)
+{
+	size_t found = 0;
+	double deadline = now() + BENCH_TIMEOUT;
+	while (true)
+	{
+		size_t position;
+		while (found < count && (position = pending.find(token)) != std::string::npos)
+		{
+			pending.erase(0, position + token.size());
+			found++;
+		}
+		if (found == count)
+			return found;
+		if (pending.size() > token.size())
+			pending.erase(0, pending.size() - token.size()); //keep a possible partial match only
+
+		struct pollfd pfd;
+		pfd.fd = fd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		int timeout = static_cast<int>((deadline - now()) * 1000);
+		if (timeout <= 0 || poll(&pfd, 1, timeout) <= 0)
+			return found;
+		char buffer[65536];
+		ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+		if (received <= 0)
+			return found;
+		pending.append(buffer, received);
+		deadline = now() + BENCH_TIMEOUT;
+	}
+}
+
+/**
+ * @brief A started server process.
+ */
+struct ServerProcess
+{
+	pid_t pid;
+	int port;
+};
+
+/**
+ * @brief Starts the server binary with the bench password, stdout and stderr discarded.
+ * @param preload Shared object to LD_PRELOAD (see mcount.cpp), NULL for none
+ * @return ServerProcess Once the server accepts connections
+ */
+static ServerProcess startServer(const std::string &binary, int port, const std::vector<std::string> &options, const char *preload)
+{
+	std::ostringstream portString;
+	portString << port;
+	std::vector<std::string> args;
+	args.push_back(binary);
+	args.push_back(portString.str());
+	args.push_back(BENCH_PASSWORD);
+	args.insert(args.end(), options.begin(), options.end());
+
+	ServerProcess server;
+	server.port = port;
+	server.pid = fork();
+	if (server.pid < 0)
+		fail("fork() failed");
+	if (server.pid == 0)
+	{
+		int devnull = open("/dev/null", O_WRONLY);
+		dup2(devnull, STDOUT_FILENO);
+		dup2(devnull, STDERR_FILENO);
+		if (preload)
+			setenv("LD_PRELOAD", preload, 1);
+		std::vector<char *> argv;
+		for (size_t i = 0; i < args.size(); i++)
+			argv.push_back(const_cast<char *>(args[i].c_str()));
+		argv.push_back(NULL);
+		execv(argv[0], &argv[0]);
+		_exit(127);
+	}
+	g_server = server.pid;
+	close(connectTo(port, true));
+	return server;
+}
+
+static void stopServer(ServerProcess &server)
+{
+	kill(server.pid, SIGKILL);
+	waitpid(server.pid, NULL, 0);
+	g_server = 0;
+}
+
+/**
+ * @brief The lines that register a client under nick.
+ */
+static std::string registration(const std::string &nick)
+{
+	return "PASS " BENCH_PASSWORD "\r\nNICK " + nick + "\r\nUSER " + nick + " 0 * :" + nick + "\r\n";
+}
+
+/**
+ * @brief Connects and registers a client, returns once 001 arrived.
+ */
+static int registerClient(int port, const std::string &nick)
+{
+	int fd = connectTo(port, false);
+	sendAll(fd, registration(nick));
+	std::string pending;
+	if (expect(fd, pending, " 001 ", 1) != 1)
+		fail("registration of " + nick + " timed out");
+	return fd;
+}
+
+/**
+ * @brief Reads and discards until the server closes the connection.
+ * @return bool False if it was still open after BENCH_TIMEOUT
+ */
+static bool waitClosed(int fd)
+{
+	double deadline = now() + BENCH_TIMEOUT;
+	while (true)
+	{
+		struct pollfd pfd;
+		pfd.fd = fd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		int timeout = static_cast<int>((deadline - now()) * 1000);
+		if (timeout <= 0 || poll(&pfd, 1, timeout) <= 0)
+			return false;
+		char buffer[4096];
+		if (recv(fd, buffer, sizeof(buffer), 0) <= 0)
+			return true;
+	}
+}
+
+static void closeAll(std::vector<int> &fds)
+{
+	for (size_t i = 0; i < fds.size(); i++)
+		close(fds[i]);
+	fds.clear();
+}
+
+/**
+ * @brief Counts the occurrences of token in the bytes received so far.
+ * @param pending Received bytes, consumed up to the last match (a possible partial match is kept)
+ */
+static size_t countToken(std::string &pending, const std::string &token)
+{
+	size_t found = 0;
+	size_t position = 0;
+	size_t next;
+	while ((next = pending.find(token, position)) != std::string::npos)
+	{
+		found++;
+		position = next + token.size();
+	}
+	pending.erase(0, std::max(position, pending.size() > token.size() ? pending.size() - token.size() : 0));
+	return found;
+}
+
+/**
+ * @brief Reads and discards whatever a socket has received so far, without blocking.
+ */
+static void drainAvailable(int fd)
+{
+	char buffer[65536];
+	while (recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT) > 0)
+		;
+}
+
+/**
+ * @brief Heap counters of a server started with bench/mcount.so preloaded.
+ */
+struct HeapCounts
+{
+	unsigned long allocations;
+	unsigned long bytes; //bytes requested by those allocations
+};
+
+/**
+ * @brief Reads the heap counters of a server started with bench/mcount.so preloaded.
+ * @param output The file mcount.so appends to (MCOUNT_OUTPUT), emptied before each dump
+ */
+static HeapCounts heapCounts(pid_t pid, const std::string &output)
+{
+	unlink(output.c_str());
+	kill(pid, SIGUSR1);
+	double deadline = now() + BENCH_TIMEOUT;
+	while (now() < deadline)
+	{
+		FILE *file = fopen(output.c_str(), "r");
+		HeapCounts counts;
+		if (file && fscanf(file, "%lu %*u %lu", &counts.allocations, &counts.bytes) == 2)
+		{
+			fclose(file);
+			return counts;
+		}
+		if (file)
+			fclose(file);
+		usleep(10000);
+	}
+	fail("no allocation count from " + output + " (was bench/mcount.so preloaded?)");
+	return HeapCounts();
+}
+
+/**
+ * @brief Resolves the mcount.so to preload and points MCOUNT_OUTPUT to a file of this process.
+ * @param path mcount.so as given on the command line, NULL for bench/mcount.so
+ * @param preload Receives the absolute path of mcount.so (PATH_MAX bytes)
+ * @return std::string The MCOUNT_OUTPUT file, to pass to heapCounts()
+ */
+static std::string setupMcount(const char *path, char *preload)
+{
+	if (!realpath(path ? path : "bench/mcount.so", preload))
+		fail("mcount.so not found, run make bench");
+	std::ostringstream output;
+	output << "/tmp/ircbench_mcount." << getpid();
+	setenv("MCOUNT_OUTPUT", output.str().c_str(), 1);
+	return output.str();
+}
+
+/**
+ * @brief Sends lines[i] to client i, connecting it first when fds has no entry for it yet.
+ * @details Nothing waits for the replies of a single client. Every JOIN_BATCH clients, a marker
+ * of the last one tells that the server went through the batch, and what all the clients
+ * received so far is discarded.
+ */
+static void sendInBatches(int port, std::vector<int> &fds, const std::vector<std::string> &lines)
+{
+	for (size_t i = 0; i < lines.size(); i++)
+	{
+		if (i == fds.size())
+			fds.push_back(connectTo(port, false));
+		sendAll(fds[i], lines[i]);
+		if ((i + 1) % JOIN_BATCH == 0 || i + 1 == lines.size())
+		{
+			std::string pending;
+			sendAll(fds[i], "MARK\r\n");
+			if (expect(fds[i], pending, "MARK", 1) != 1)
+				fail("a batch of commands was not answered");
+			for (size_t j = 0; j < fds.size(); j++)
+				drainAvailable(fds[j]);
+		}
+	}
+	usleep(200000); //replies still being written to the last batch
+	for (size_t i = 0; i < fds.size(); i++)
+		drainAvailable(fds[i]);
+}
+
+/**
+ * @brief Registers count clients named <prefix>0, <prefix>1... and joins them all to channel.
+ */
+static std::vector<int> joinMembers(int port, const std::string &prefix, long count, const std::string &channel)
+{
+	std::vector<int> fds;
+	std::vector<std::string> lines;
+	for (long c = 0; c < count; c++)
+	{
+		std::ostringstream nick;
+		nick << prefix << c;
+		lines.push_back(registration(nick.str()) + "JOIN " + channel + "\r\n");
+	}
+	sendInBatches(port, fds, lines);
+	return fds;
+}
+
+/**
+ * @brief Resident memory of a process, in kB (VmRSS of /proc/<pid>/status).
+ */
+static long rssKb(pid_t pid)
+{
+	std::ostringstream path;
+	path << "/proc/" << pid << "/status";
+	FILE *file = fopen(path.str().c_str(), "r");
+	if (!file)
+		fail("cannot read " + path.str());
+	char line[256];
+	long kb = -1;
+	while (kb < 0 && fgets(line, sizeof(line), file))
+		sscanf(line, "VmRSS: %ld", &kb);
+	fclose(file);
+	if (kb < 0)
+		fail("no VmRSS in " + path.str());
+	return kb;
+}
+
+static std::vector<long> parseList(const std::string &list)
+{
+	std::vector<long> values;
+	std::istringstream stream(list);
+	std::string item;
+	while (std::getline(stream, item, ','))
+		values.push_back(atol(item.c_str()));
+	return values;
+}
+
+
+/******************/
+/*    Scenarios   */
+/******************/
+
+/**
+ * @brief Wakeup cost against idle connection count.
+ * @details For each idle count, opens that many connections that never send anything,
+ * then one registered client makes `rounds` request/reply round trips (an unknown
+ * command answered by 421). Each round trip is one readiness wakeup of the server;
+ * its CPU time per round trip shows what an event loop pays for the idle sockets, and
+ * any per-line cost that grows with the client count (a linear client lookup, say).
+ * Arguments: <rounds> <idle,idle,...>
+ */
+static void wakeup(const std::string &binary, int port, const std::vector<std::string> &args, const std::vector<std::string> &options)
+{
+	if (args.size() < 2)
+		fail("usage: wakeup <binary> <port> <rounds> <idle,idle,...> [-- options]");
+	long rounds = atol(args[0].c_str());
+	std::vector<long> idleCounts = parseList(args[1]);
+
+	std::cout << "idle connections   server CPU per wakeup   round trip" << std::endl;
+	for (size_t i = 0; i < idleCounts.size(); i++)
+	{
+		ServerProcess server = startServer(binary, port, options, NULL);
+		std::vector<int> idle;
+		for (long c = 0; c < idleCounts[i]; c++)
+			idle.push_back(connectTo(port, false));
+		int active = registerClient(port, "bench");
+		std::string pending;
+		for (int warmup = 0; warmup < 100; warmup++)
+		{
+			sendAll(active, "WAKEUP\r\n");
+			expect(active, pending, " 421 ", 1);
+		}
+
+		double cpu = cpuSeconds(server.pid);
+		double start = now();
+		for (long r = 0; r < rounds; r++)
+		{
+			sendAll(active, "WAKEUP\r\n");
+			if (expect(active, pending, " 421 ", 1) != 1)
+				fail("no reply to the wakeup round trip");
+		}
+		double wall = now() - start;
+		cpu = cpuSeconds(server.pid) - cpu;
+
+		std::cout << std::setw(16) << idleCounts[i] << std::fixed << std::setprecision(2)
+			<< std::setw(20) << cpu / rounds * 1e6 << " us"
+			<< std::setw(15) << wall / rounds * 1e6 << " us" << std::endl;
+		close(active);
+		closeAll(idle);
+		stopServer(server);
+	}
+}
+
+/**
+ * @brief Message throughput against the number of reactor threads.
+ * @details For each thread count, starts the server with --threads N and registers `pairs`
+ * sender/receiver pairs. Every sender keeps SCALING_WINDOW private messages in flight to its
+ * receiver and sends one more for each one delivered, for `seconds`. Pairs are independent, so
+ * with the reactors running their I/O in parallel the delivered rate should follow the cores.
+ * Arguments: <seconds> <pairs> <threads,threads,...>
+ */
+static void scaling(const std::string &binary, int port, const std::vector<std::string> &args, const std::vector<std::string> &options)
+{
+	if (args.size() < 3)
+		fail("usage: scaling <binary> <port> <seconds> <pairs> <threads,threads,...> [-- options]");
+	double seconds = atof(args[0].c_str());
+	long pairs = atol(args[1].c_str());
+	std::vector<long> threadCounts = parseList(args[2]);
+	std::string payload(100, 'x');
+
+	std::cout << "threads   delivered/s   server CPU (cores)   online CPUs: " << sysconf(_SC_NPROCESSORS_ONLN) << std::endl;
+	for (size_t t = 0; t < threadCounts.size(); t++)
+	{
+		std::vector<std::string> serverOptions(options);
+		std::ostringstream threads;
+		threads << threadCounts[t];
+		serverOptions.push_back("--threads");
+		serverOptions.push_back(threads.str());
+		ServerProcess server = startServer(binary, port, serverOptions, NULL);
+
+		std::vector<int> senders, receivers;
+		std::vector<std::string> lines, pending(pairs);
+		std::vector<struct pollfd> pfds;
+		for (long p = 0; p < pairs; p++)
+		{
+			std::ostringstream from, to;
+			from << "s" << p;
+			to << "r" << p;
+			senders.push_back(registerClient(port, from.str()));
+			receivers.push_back(registerClient(port, to.str()));
+			lines.push_back("PRIVMSG " + to.str() + " :" + payload + "\r\n");
+			struct pollfd pfd;
+			pfd.fd = receivers.back();
+			pfd.events = POLLIN;
+			pfd.revents = 0;
+			pfds.push_back(pfd);
+		}
+		for (long p = 0; p < pairs; p++)
+		{
+			std::string window;
+			for (int w = 0; w < SCALING_WINDOW; w++)
+				window += lines[p];
+			sendAll(senders[p], window);
+		}
+
+		unsigned long delivered = 0;
+		double cpu = cpuSeconds(server.pid);
+		double start = now();
+		while (now() - start < seconds)
+		{
+			if (poll(&pfds[0], pfds.size(), 1000) <= 0)
+				fail("no message delivered for a second");
+			for (long p = 0; p < pairs; p++)
+			{
+				if (!(pfds[p].revents & POLLIN))
+					continue;
+				char buffer[65536];
+				ssize_t received = recv(receivers[p], buffer, sizeof(buffer), 0);
+				if (received <= 0)
+					fail("a receiver was disconnected");
+				pending[p].append(buffer, received);
+				size_t count = countToken(pending[p], " PRIVMSG ");
+				delivered += count;
+				std::string refill;
+				for (size_t c = 0; c < count; c++)
+					refill += lines[p];
+				sendAll(senders[p], refill);
+			}
+		}
+		double wall = now() - start;
+		cpu = cpuSeconds(server.pid) - cpu;
+
+		std::cout << std::setw(7) << threadCounts[t] << std::fixed << std::setprecision(0)
+			<< std::setw(14) << delivered / wall << std::setprecision(2)
+			<< std::setw(21) << cpu / wall << std::endl;
+		closeAll(senders);
+		closeAll(receivers);
+		stopServer(server);
+	}
+}
+
+/**
+ * @brief Connect/disconnect churn rate against the number of connected clients.
+ * @details For each client count, registers that many clients that stay connected, then
+ * for `seconds` one connection at a time is opened, registered and closed by QUIT, each
+ * one waiting for the server to close the previous. Prints the connections per second
+ * and the server CPU per connection.
+ * Arguments: <seconds> <clients,clients,...>
+ */
+static void churn(const std::string &binary, int port, const std::vector<std::string> &args, const std::vector<std::string> &options)
+{
+	if (args.size() < 2)
+		fail("usage: churn <binary> <port> <seconds> <clients,clients,...> [-- options]");
+	double seconds = atof(args[0].c_str());
+	std::vector<long> clientCounts = parseList(args[1]);
+
+	std::cout << "connected clients   connections/s   server CPU per connection" << std::endl;
+	for (size_t i = 0; i < clientCounts.size(); i++)
+	{
+		ServerProcess server = startServer(binary, port, options, NULL);
+		std::vector<int> connected;
+		for (long c = 0; c < clientCounts[i]; c++)
+		{
+			std::ostringstream nick;
+			nick << "idle" << c;
+			connected.push_back(registerClient(port, nick.str()));
+		}
+
+		unsigned long connections = 0;
+		double cpu = cpuSeconds(server.pid);
+		double start = now();
+		while (now() - start < seconds)
+		{
+			std::ostringstream nick;
+			nick << "churn" << connections;
+			int fd = connectTo(port, false);
+			sendAll(fd, registration(nick.str()) + "QUIT :bye\r\n");
+			if (!waitClosed(fd))
+				fail("the server did not close " + nick.str() + " after its QUIT");
+			close(fd);
+			connections++;
+		}
+		double wall = now() - start;
+		cpu = cpuSeconds(server.pid) - cpu;
+
+		std::cout << std::setw(17) << clientCounts[i] << std::fixed << std::setprecision(0)
+			<< std::setw(16) << connections / wall << std::setprecision(1)
+			<< std::setw(24) << cpu / connections * 1e6 << " us" << std::endl;
+		closeAll(connected);
+		stopServer(server);
+	}
+}
+
+/**
+ * @brief NICK rename rate against the number of registered clients.
+ * @details For each client count, registers that many clients, then every client renames
+ * itself once per cycle to a nick no one holds. Renames are sent JOIN_BATCH clients at a time,
+ * the last client of the batch following its NICK with an unknown command whose 421 tells
+ * that the server went through the batch. Each rename is a collision check, an update of
+ * the nick index and the echo to the client; prints the renames per second and the server
+ * CPU per rename.
+ * @note Every client is a socket at both ends of the loopback, so the count stays under the
+ * open file limit of the two processes (ulimit -n).
+ * Arguments: <cycles> <clients,clients,...>
+ */
+static void nickchurn(const std::string &binary, int port, const std::vector<std::string> &args, const std::vector<std::string> &options)
+{
+	if (args.size() < 2)
+		fail("usage: nickchurn <binary> <port> <cycles> <clients,clients,...> [-- options]");
+	long cycles = atol(args[0].c_str());
+	std::vector<long> clientCounts = parseList(args[1]);
+
+	std::cout << "registered clients   renames/s   server CPU per rename" << std::endl;
+	for (size_t i = 0; i < clientCounts.size(); i++)
+	{
+		ServerProcess server = startServer(binary, port, options, NULL);
+		std::vector<int> fds;
+		std::vector<std::string> lines;
+		for (long c = 0; c < clientCounts[i]; c++)
+		{
+			std::ostringstream nick;
+			nick << "n" << c;
+			lines.push_back(registration(nick.str()));
+		}
+		sendInBatches(port, fds, lines);
+
+		double cpu = cpuSeconds(server.pid);
+		double start = now();
+		for (long cycle = 1; cycle <= cycles; cycle++)
+		{
+			for (size_t c = 0; c < fds.size(); c++)
+			{
+				std::ostringstream nick;
+				nick << "NICK n" << c << "_" << cycle << "\r\n";
+				sendAll(fds[c], nick.str());
+				if ((c + 1) % JOIN_BATCH == 0 || c + 1 == fds.size())
+				{
+					std::string pending;
+					sendAll(fds[c], "MARK\r\n");
+					if (expect(fds[c], pending, "MARK", 1) != 1)
+						fail("a batch of renames was not answered");
+					for (size_t j = c - c % JOIN_BATCH; j < c; j++)
+						drainAvailable(fds[j]);
+				}
+			}
+		}
+		double wall = now() - start;
+		cpu = cpuSeconds(server.pid) - cpu;
+
+		double renames = static_cast<double>(cycles) * fds.size();
+		std::cout << std::setw(18) << fds.size() << std::fixed << std::setprecision(0)
+			<< std::setw(12) << renames / wall << std::setprecision(1)
+			<< std::setw(20) << cpu / renames * 1e6 << " us" << std::endl;
+		closeAll(fds);
+		stopServer(server);
+	}
+}
+
+/**
+ * @brief Server memory per channel membership.
+ * @details Clients come in groups of `perClient`, and the members of a group all join the same
+ * `perClient` channels: `clients` channels holding clients * perClient memberships. The first
+ * client of each group creates its channels, then the resident memory of the server is read;
+ * the other clients join, and the growth of the resident memory per membership they added is
+ * printed, along with the time those joins took.
+ * Arguments: <clients> <channels per client>
+ */
+static void members(const std::string &binary, int port, const std::vector<std::string> &args, const std::vector<std::string> &options)
+{
+	if (args.size() < 2)
+		fail("usage: members <binary> <port> <clients> <channels per client> [-- options]");
+	long clients = atol(args[0].c_str());
+	long perClient = atol(args[1].c_str());
+	if (perClient < 1 || clients % perClient)
+		fail("clients must be a multiple of the channels per client");
+
+	ServerProcess server = startServer(binary, port, options, NULL);
+	std::vector<int> fds;
+	std::vector<std::string> creators(clients), joiners(clients);
+	for (long c = 0; c < clients; c++)
+	{
+		std::ostringstream nick, join;
+		nick << "u" << c;
+		join << "JOIN ";
+		for (long k = 0; k < perClient; k++)
+			join << (k ? "," : "") << "#g" << c / perClient << "_" << k;
+		join << "\r\n";
+		creators[c] = registration(nick.str());
+		if (c % perClient == 0)
+			creators[c] += join.str();
+		else
+			joiners[c] = join.str();
+	}
+	sendInBatches(port, fds, creators);
+	long created = rssKb(server.pid);
+	double start = now();
+	sendInBatches(port, fds, joiners);
+	double wall = now() - start;
+	long joined = rssKb(server.pid);
+
+	long added = clients * perClient - clients;
+	std::cout << "memberships: " << clients * perClient << " in " << clients << " channels" << std::endl
+		<< "RSS after creating the channels: " << created << " kB" << std::endl
+		<< "RSS after the other joins:       " << joined << " kB" << std::endl << std::fixed << std::setprecision(0)
+		<< "per added membership:            " << (joined - created) * 1024.0 / added << " bytes" << std::endl
+		<< std::setprecision(1) << "time of the " << added << " joins:      " << wall << " s" << std::endl;
+	closeAll(fds);
+	stopServer(server);
+}
+
+/**
+ * @brief Time of a mass disconnect against the number of channels on the server.
+ * @details For each channel count, holder clients create the channels ten at a time, an
+ * observer creates #o0 to #o9, and `victims` clients each join one #o channel and nine of the
+ * others. All the victims then send QUIT at once; the observer shares exactly one channel with
+ * each of them, so its QUIT count tells when the server went through all the disconnects.
+ * Arguments: <victims> <channels,channels,...> (multiples of 10)
+ */
+static void massdc(const std::string &binary, int port, const std::vector<std::string> &args, const std::vector<std::string> &options)
+{
+	if (args.size() < 2)
+		fail("usage: massdc <binary> <port> <victims> <channels,channels,...> [-- options]");
+	long victims = atol(args[0].c_str());
+	std::vector<long> channelCounts = parseList(args[1]);
+
+	std::cout << "channels   victims   disconnect time   server CPU per disconnect" << std::endl;
+	for (size_t i = 0; i < channelCounts.size(); i++)
+	{
+		long channels = channelCounts[i];
+		if (channels < 10 || channels % 10)
+			fail("the channel count must be a multiple of 10");
+		ServerProcess server = startServer(binary, port, options, NULL);
+		std::vector<int> holders, quitting;
+		std::vector<std::string> lines;
+		for (long h = 0; h < channels / 10; h++)
+		{
+			std::ostringstream nick, join;
+			nick << "h" << h;
+			join << "JOIN ";
+			for (long k = 0; k < 10; k++)
+				join << (k ? "," : "") << "#c" << h * 10 + k;
+			lines.push_back(registration(nick.str()) + join.str() + "\r\n");
+		}
+		sendInBatches(port, holders, lines);
+		int observer = registerClient(port, "obs");
+		sendAll(observer, "JOIN #o0,#o1,#o2,#o3,#o4,#o5,#o6,#o7,#o8,#o9\r\n");
+		lines.clear();
+		for (long v = 0; v < victims; v++)
+		{
+			std::ostringstream nick, join;
+			nick << "v" << v;
+			join << "JOIN #o" << v % 10;
+			for (long k = 0; k < 9; k++)
+				join << ",#c" << (v * 9 + k) % channels;
+			lines.push_back(registration(nick.str()) + join.str() + "\r\n");
+		}
+		sendInBatches(port, quitting, lines);
+		drainAvailable(observer);
+
+		std::string pending;
+		double cpu = cpuSeconds(server.pid);
+		double start = now();
+		for (long v = 0; v < victims; v++)
+			sendAll(quitting[v], "QUIT :bye\r\n");
+		if (expect(observer, pending, " QUIT ", victims) != static_cast<size_t>(victims))
+			fail("the observer did not see every QUIT");
+		double wall = now() - start;
+		cpu = cpuSeconds(server.pid) - cpu;
+
+		std::cout << std::setw(8) << channels << std::setw(10) << victims << std::fixed << std::setprecision(1)
+			<< std::setw(15) << wall * 1e3 << " ms" << std::setw(25) << cpu / victims * 1e6 << " us" << std::endl;
+		close(observer);
+		closeAll(quitting);
+		closeAll(holders);
+		stopServer(server);
+	}
+}
+
+/**
+ * @brief Heap allocations per command line, for the most common commands.
+ * @details Starts the server with bench/mcount.so preloaded. Client "a" (channel operator)
+ * and client "b" share #c, b is also in #e. For each command, "a" sends `lines` copies in
+ * batches of MALLOC_BATCH, each followed by an unknown command whose 421 tells that the batch
+ * was handled; b then sends one too, so that the next batch only starts once b read all it was
+ * sent. The allocations of those markers are measured on their own and subtracted.
+ *
+ * What still allocates in steady state, printed after the table:
+ * - Send queues: a std::deque node (64 replies) per client every 64 queued replies
+ * - NICK: the nick registry erases and inserts the entry of the renamed client
+ * - JOIN + PART of a channel that did not exist: the Channel and its directory entry
+ * - Channel and nick lookups build a std::string key, on the heap past 15 bytes
+ *   (the bench uses short names)
+ * - A reply over SHARED_BUFFER_POOLED_SIZE bytes, or more replies in flight at once than
+ *   ever before (the SharedBuffer free list grows)
+ * Arguments: <lines> [path of mcount.so, default bench/mcount.so]
+ */
+static void mallocs(const std::string &binary, int port, const std::vector<std::string> &args, const std::vector<std::string> &options)
+{
+	if (args.size() < 1)
+		fail("usage: mallocs <binary> <port> <lines> [mcount.so] [-- options]");
+	long lines = atol(args[0].c_str());
+	char preload[PATH_MAX];
+	std::string output = setupMcount(args.size() > 1 ? args[1].c_str() : NULL, preload);
+
+	ServerProcess server = startServer(binary, port, options, preload);
+	int a = registerClient(port, "a");
+	int b = registerClient(port, "b");
+	std::string pending, pendingB;
+	sendAll(a, "JOIN #c\r\nTOPIC #c :bench\r\nMARK\r\n");
+	expect(a, pending, "MARK", 1);
+	sendAll(b, "JOIN #c,#e\r\nMARK\r\n");
+	expect(b, pendingB, "MARK", 1);
+
+	struct Case
+	{
+		const char *name;
+		const char *line;
+	};
+	const Case cases[] = {
+		{"marker (421)", ""},
+		{"PRIVMSG #chan", "PRIVMSG #c :hello there\r\n"},
+		{"PRIVMSG user", "PRIVMSG b :hello there\r\n"},
+		{"MODE +t / -t", "MODE #c +t\r\nMODE #c -t\r\n"},
+		{"JOIN + PART", "JOIN #e\r\nPART #e\r\n"},
+		{"JOIN + PART new", "JOIN #d\r\nPART #d\r\n"},
+		{"TOPIC #chan", "TOPIC #c\r\n"},
+		{"NICK", "NICK a2\r\nNICK a\r\n"},
+		{"unknown", "FOO bar\r\n"}
+	};
+	double markerCost = 0;
+	std::cout << "command          allocations per line" << std::endl;
+	for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+	{
+		std::string line(cases[c].line);
+		size_t perLine = std::count(line.begin(), line.end(), '\n');
+		std::string batch;
+		for (int i = 0; i < MALLOC_BATCH; i++)
+			batch += line;
+		batch += "MARK\r\n";
+		long batches = (lines + MALLOC_BATCH - 1) / MALLOC_BATCH;
+
+		unsigned long before = heapCounts(server.pid, output).allocations;
+		for (long i = 0; i < batches; i++)
+		{
+			sendAll(a, batch);
+			if (expect(a, pending, "MARK", 1) != 1)
+				fail("batch of " + std::string(cases[c].name) + " not answered");
+			sendAll(b, "MARK\r\n"); //queued behind what b was sent: b is drained before the next batch
+			if (expect(b, pendingB, "MARK", 1) != 1)
+				fail("b did not receive the batch of " + std::string(cases[c].name));
+		}
+		double allocations = heapCounts(server.pid, output).allocations - before;
+		if (perLine == 0)
+		{
+			markerCost = allocations / batches;
+			continue;
+		}
+		allocations -= markerCost * batches;
+		std::cout << std::left << std::setw(17) << cases[c].name << std::right << std::fixed << std::setprecision(2)
+			<< allocations / (batches * MALLOC_BATCH * perLine) << std::endl;
+	}
+	std::cout << "(each batch marker cost " << markerCost << " allocations, subtracted)" << std::endl
+		<< "still allocating: send queue deque nodes (1 per 64 replies), the nick registry entry of a NICK," << std::endl
+		<< "the Channel and directory entry of a new channel, lookup keys of names over 15 bytes" << std::endl;
+	close(a);
+	close(b);
+	stopServer(server);
+	unlink(output.c_str());
+}
+
+/**
+ * @brief Allocations, bytes allocated and CPU time (total and user) per channel message, against the channel size.
+ * @details Starts the server with bench/mcount.so preloaded. For each member count, that many
+ * clients join #f and the first one sends `messages` PRIVMSGs of FANOUT_PAYLOAD bytes to it, in
+ * batches of FANOUT_BATCH closed by an unknown command whose 421 tells that the batch was handled;
+ * every other member must receive the whole batch before the next one is sent. The same number of
+ * markers is first measured alone and subtracted.
+ * Arguments: <messages> <members,members,...> [path of mcount.so, default bench/mcount.so]
+ */
+static void fanout(const std::string &binary, int port, const std::vector<std::string> &args, const std::vector<std::string> &options)
+{
+	if (args.size() < 2)
+		fail("usage: fanout <binary> <port> <messages> <members,members,...> [mcount.so] [-- options]");
+	long messages = atol(args[0].c_str());
+	std::vector<long> memberCounts = parseList(args[1]);
+	char preload[PATH_MAX];
+	std::string output = setupMcount(args.size() > 2 ? args[2].c_str() : NULL, preload);
+	long batches = (messages + FANOUT_BATCH - 1) / FANOUT_BATCH;
+	messages = batches * FANOUT_BATCH;
+	std::string batch;
+	for (int i = 0; i < FANOUT_BATCH; i++)
+		batch += "PRIVMSG #f :" + std::string(FANOUT_PAYLOAD, 'x') + "\r\n";
+
+	std::cout << "recipients   allocations   bytes allocated   server CPU   of which user   (per channel message)" << std::endl;
+	for (size_t m = 0; m < memberCounts.size(); m++)
+	{
+		ServerProcess server = startServer(binary, port, options, preload);
+		std::vector<int> members = joinMembers(port, "m", memberCounts[m], "#f");
+		std::vector<std::string> pending(members.size());
+
+		HeapCounts markers = heapCounts(server.pid, output);
+		double markerCpu = cpuSeconds(server.pid);
+		double markerUser = cpuSeconds(server.pid, true);
+		for (long b = 0; b < batches; b++)
+		{
+			sendAll(members[0], "MARK\r\n");
+			if (expect(members[0], pending[0], "MARK", 1) != 1)
+				fail("marker not answered");
+		}
+		HeapCounts before = heapCounts(server.pid, output);
+		double cpu = cpuSeconds(server.pid);
+		double user = cpuSeconds(server.pid, true);
+		markerCpu = cpu - markerCpu;
+		markerUser = user - markerUser;
+		markers.allocations = before.allocations - markers.allocations;
+		markers.bytes = before.bytes - markers.bytes;
+
+		for (long b = 0; b < batches; b++)
+		{
+			sendAll(members[0], batch + "MARK\r\n");
+			if (expect(members[0], pending[0], "MARK", 1) != 1)
+				fail("batch of channel messages not answered");
+			for (size_t i = 1; i < members.size(); i++)
+				if (expect(members[i], pending[i], " PRIVMSG ", FANOUT_BATCH) != FANOUT_BATCH)
+					fail("a member did not receive the whole batch");
+		}
+		cpu = cpuSeconds(server.pid) - cpu - markerCpu;
+		user = cpuSeconds(server.pid, true) - user - markerUser;
+		HeapCounts after = heapCounts(server.pid, output);
+
+		std::cout << std::setw(10) << members.size() - 1 << std::fixed << std::setprecision(2)
+			<< std::setw(14) << static_cast<double>(after.allocations - before.allocations - markers.allocations) / messages
+			<< std::setw(18) << std::setprecision(0) << static_cast<double>(after.bytes - before.bytes - markers.bytes) / messages
+			<< std::setw(11) << std::setprecision(1) << cpu / messages * 1e6 << " us"
+			<< std::setw(13) << user / messages * 1e6 << " us" << std::endl;
+		closeAll(members);
+		stopServer(server);
+	}
+	unlink(output.c_str());
+}
+
+int main(int ac, char **av)
+{
+	if (ac < 4)
+	{
+		std::cerr << "Usage: ircbench <scenario> <binary> <port> [arguments] [-- server options]" << std::endl
+			<< "Scenarios: wakeup, scaling, churn, nickchurn, members, massdc, mallocs, fanout" << std::endl;
+		return 1;
+	}
+	std::string scenario(av[1]);
+	std::string binary(av[2]);
+	int port = atoi(av[3]);
+	std::vector<std::string> args;
+	std::vector<std::string> options;
+	bool serverOptions = false;
+	for (int i = 4; i < ac; i++)
+	{
+		if (std::string(av[i]) == "--" && !serverOptions)
+			serverOptions = true;
+		else if (serverOptions)
+			options.push_back(av[i]);
+		else
+			args.push_back(av[i]);
+	}
+	signal(SIGPIPE, SIG_IGN);
+
+	if (scenario == "wakeup")
+		wakeup(binary, port, args, options);
+	else if (scenario == "scaling")
+		scaling(binary, port, args, options);
+	else if (scenario == "churn")
+		churn(binary, port, args, options);
+	else if (scenario == "nickchurn")
+		nickchurn(binary, port, args, options);
+	else if (scenario == "members")
+		members(binary, port, args, options);
+	else if (scenario == "massdc")
+		massdc(binary, port, args, options);
+	else if (scenario == "mallocs")
+		mallocs(binary, port, args, options);
+	else if (scenario == "fanout")
+		fanout(binary, port, args, options);
+	else
+		fail("unknown scenario " + scenario);
+	return 0;
+}
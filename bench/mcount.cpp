@@ -0,0 +1,101 @@
+#include <cstdlib>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @file mcount.cpp
+ * @brief Allocation counter preloaded into the server by the ircbench "mallocs" and "fanout" scenarios.
+ *
+ * @details Built as bench/mcount.so and injected with LD_PRELOAD, it counts the calls to
+ * malloc, calloc and realloc and the bytes they asked for, and forwards them to glibc. On SIGUSR1
+ * it appends "<allocations> <frees> <bytes>" to the file named by the MCOUNT_OUTPUT environment variable.
+ * @note glibc only (__libc_malloc and friends)
+ */
+
+extern "C"
+{
+	void *__libc_malloc(size_t size);
+	void *__libc_calloc(size_t count, size_t size);
+	void *__libc_realloc(void *pointer, size_t size);
+	void __libc_free(void *pointer);
+}
+
+static unsigned long g_allocations = 0;
+static unsigned long g_frees = 0;
+static unsigned long g_bytes = 0; //bytes requested by the counted allocations
+static const char *g_output = NULL; //MCOUNT_OUTPUT, read once at load time
+
+extern "C" void *malloc(size_t size)
+{
+	__atomic_add_fetch(&g_allocations, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&g_bytes, size, __ATOMIC_RELAXED);
+	return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+	__atomic_add_fetch(&g_allocations, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&g_bytes, count * size, __ATOMIC_RELAXED);
+	return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *pointer, size_t size)
+{
+	__atomic_add_fetch(&g_allocations, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&g_bytes, size, __ATOMIC_RELAXED);
+	return __libc_realloc(pointer, size);
+}
+
+extern "C" void free(void *pointer)
+{
+	if (pointer)
+		__atomic_add_fetch(&g_frees, 1, __ATOMIC_RELAXED);
+	__libc_free(pointer);
+}
+
+/**
+ * @brief Writes value in decimal at the end of line, returns the new length.
+ */
+static size_t appendNumber(char *line, size_t length, unsigned long value)
+{
+	char digits[24];
+	size_t count = 0;
+	do
+	{
+		digits[count++] = '0' + value % 10;
+		value /= 10;
+	} while (value);
+	while (count)
+		line[length++] = digits[--count];
+	return length;
+}
+
+/**
+ * @brief SIGUSR1 handler: only async-signal-safe calls (open, write, close), no allocation.
+ */
+static void dumpCounts(int sig)
+{
+	(void)sig;
+	if (!g_output)
+		return;
+	char line[64];
+	size_t length = appendNumber(line, 0, __atomic_load_n(&g_allocations, __ATOMIC_RELAXED));
+	line[length++] = ' ';
+	length = appendNumber(line, length, __atomic_load_n(&g_frees, __ATOMIC_RELAXED));
+	line[length++] = ' ';
+	length = appendNumber(line, length, __atomic_load_n(&g_bytes, __ATOMIC_RELAXED));
+	line[length++] = '\n';
+	int fd = open(g_output, O_WRONLY | O_CREAT | O_APPEND, 0644);
+	if (fd < 0)
+		return;
+	if (write(fd, line, length) < 0)
+		length = 0;
+	close(fd);
+}
+
+__attribute__((constructor)) static void installHandler()
+{
+	g_output = getenv("MCOUNT_OUTPUT");
+	signal(SIGUSR1, dumpCounts);
+}
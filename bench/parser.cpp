@@ -0,0 +1,318 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sys/time.h>
+#include "Server.hpp"
+
+/**
+ * @file parser.cpp
+ * @brief Microbenchmarks of the input path against the code it replaced: LineFramer against
+ * split_receivedBuffer(), then the two steps of Server::parser(), Message::parse() against
+ * split_cmd() and Server::findCommand() against the two std::map lookups.
+ *
+ * @details The framers split FRAMER_BYTES of mixed-length lines, read READ_CHUNK_SIZE bytes at a
+ * time, and their throughput in MB/s is printed. The parser steps each run `iterations` times
+ * over a command mix, and the time and the heap allocations (operator new, counted below) per
+ * line are printed.
+ * Usage: parser [iterations]
+ */
+
+#define FRAMER_BYTES (64 << 20) //bytes split by each framer
+#define FRAMER_INPUT (4 << 20) //distinct input, fed FRAMER_BYTES / FRAMER_INPUT times
+
+static unsigned long g_allocations = 0;
+
+void *operator new(size_t size) throw(std::bad_alloc)
+{
+	g_allocations++;
+	void *pointer = malloc(size ? size : 1);
+	if (!pointer)
+		throw std::bad_alloc();
+	return pointer;
+}
+
+void operator delete(void *pointer) throw()
+{
+	free(pointer);
+}
+
+static double now()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/**
+ * @brief Server::split_cmd() as it was before Message, kept verbatim as the reference.
+ */
+static std::vector<std::string> split_cmd(std::string &cmd)
+{
+	std::vector<std::string> commands;
+	std::istringstream iss(cmd);
+	std::string token;
+	while(iss >> token)
+	{
+		if(token[0] == ':')
+		{
+			std::string rest;
+			std::getline(iss, rest);
+			token.erase(token.begin());
+			token = token + rest;
+		}
+		commands.push_back(token);
+		token.clear();
+	}
+	return commands;
+}
+
+/**
+ * @brief Server::normalize_param() as it was before LineFramer, kept verbatim as the reference.
+ */
+static std::string normalize_param(const std::string &s, bool flag)
+{
+	std::string result = s;
+
+	//Remove spaces/tabs at the beginnin
+	size_t start = result.find_first_not_of(" \t\r\n");
+	if (start == std::string::npos)
+		return "";
+
+	//Remove spaces/tabs at the end
+	size_t end = result.find_last_not_of(" \t\r\n");
+	if (end != std::string::npos)
+		result =  result.substr(start, end - start + 1);
+	if(flag)
+	{
+		if(!result.empty() && result[0] == ':') //Remove ':'
+			result.erase(result.begin());
+	}
+	return result;
+}
+
+/**
+ * @brief Server::split_receivedBuffer() as it was before LineFramer, kept verbatim as the reference.
+ */
+static std::vector<std::string> split_receivedBuffer(std::string buffer)
+{
+	std::vector<std::string> commands;
+	std::string line;
+	size_t start = 0;
+	size_t end;
+
+	//Search while there is "\r\n"
+	while ((end = buffer.find("\r\n", start)) != std::string::npos)
+	{
+		line = normalize_param(buffer.substr(start, end - start), false);
+		if (!line.empty())
+			commands.push_back(line);
+		start = end + 2; //skip "\r\n"
+	}
+
+	start = 0;
+	while ((end = buffer.find("\n", start)) != std::string::npos)
+	{
+		// Skip if this \n is part of \r\n (already processed above)
+		if (end > 0 && buffer[end-1] == '\r') {
+			start = end + 1;
+			continue;
+		}
+		line = normalize_param(buffer.substr(start, end - start), false);
+		if (!line.empty())
+			commands.push_back(line);
+		start = end + 1; //skip "\n"
+	}
+	return commands;
+}
+
+/**
+ * @brief Prints MB/s and allocations per line of one framer.
+ */
+static void reportFramer(const char *name, double seconds, unsigned long allocations, double bytes, double lines)
+{
+	std::cout << "  " << std::left << std::setw(22) << name << std::right << std::fixed
+		<< std::setprecision(1) << std::setw(8) << bytes / (1 << 20) / seconds << " MB/s"
+		<< std::setprecision(2) << std::setw(8) << allocations / lines << " allocations per line" << std::endl;
+}
+
+/**
+ * @brief Framing throughput over FRAMER_INPUT bytes of lines from 8 to 500 bytes, one in four
+ * ending with a bare "\n", the others with "\r\n".
+ * @details The input is read READ_CHUNK_SIZE bytes at a time, so most reads end in the middle of
+ * a line. LineFramer keeps that tail for the next read; split_receivedBuffer() runs on each read
+ * as NewData() used to, its tails lost (the bug LineFramer fixed), which only makes it cheaper.
+ */
+static void benchFramer(size_t &sink)
+{
+	std::string input;
+	size_t lines = 0;
+	for (unsigned int seed = 1; input.size() < FRAMER_INPUT; lines++)
+	{
+		seed = seed * 1103515245 + 12345;
+		size_t length = 8 + (seed >> 16) % 493;
+		std::string line = "PRIVMSG #channel :";
+		line.resize(std::max(length, line.size()), 'x');
+		input += line + (lines % 4 == 3 ? "\n" : "\r\n");
+	}
+	size_t passes = FRAMER_BYTES / FRAMER_INPUT;
+	std::cout << "framing of " << lines << " lines (" << input.size() / lines << " bytes on average), "
+		<< READ_CHUNK_SIZE << " bytes per read" << std::endl;
+
+	unsigned long allocations = g_allocations;
+	double start = now();
+	for (size_t pass = 0; pass < passes; pass++)
+		for (size_t offset = 0; offset < input.size(); offset += READ_CHUNK_SIZE)
+			sink += split_receivedBuffer(input.substr(offset, READ_CHUNK_SIZE)).size();
+	reportFramer("split_receivedBuffer", now() - start, g_allocations - allocations, passes * input.size(), passes * lines);
+
+	LineFramer framer;
+	allocations = g_allocations;
+	start = now();
+	for (size_t pass = 0; pass < passes; pass++)
+		for (size_t offset = 0; offset < input.size(); offset += READ_CHUNK_SIZE)
+		{
+			size_t available;
+			size_t bytes = std::min(static_cast<size_t>(READ_CHUNK_SIZE), input.size() - offset);
+			memcpy(framer.writeSpace(READ_CHUNK_SIZE, available), input.data() + offset, bytes);
+			framer.commit(bytes);
+			const char *line;
+			size_t length;
+			while (framer.next(line, length) != LineFramer::LINE_NONE)
+				sink += length;
+		}
+	reportFramer("LineFramer", now() - start, g_allocations - allocations, passes * input.size(), passes * lines);
+}
+
+/**
+ * @brief Prints ns and allocations per line of one parser.
+ */
+static void report(const char *name, double seconds, unsigned long allocations, long iterations)
+{
+	std::cout << "  " << std::left << std::setw(14) << name << std::right << std::fixed
+		<< std::setprecision(1) << std::setw(8) << seconds / iterations * 1e9 << " ns"
+		<< std::setprecision(2) << std::setw(8) << static_cast<double>(allocations) / iterations << " allocations" << std::endl;
+}
+
+/**
+ * @brief The dispatch of parser() before the command table: an uppercased copy of the verb
+ * looked up in the registration commands, then in the channel commands.
+ */
+struct MapDispatch
+{
+	std::map<std::string, Server::CommandHandler> registrationCommands;
+	std::map<std::string, Server::CommandHandler> channelCommands;
+
+	MapDispatch()
+	{
+		const char *registration[] = {"NICK", "USER", "PASS", "QUIT"};
+		const char *channel[] = {"JOIN", "PART", "PRIVMSG", "TOPIC", "INVITE", "KICK", "MODE"};
+		for (size_t i = 0; i < sizeof(registration) / sizeof(registration[0]); i++)
+			registrationCommands[registration[i]] = Server::findCommand(registration[i], strlen(registration[i]))->handler;
+		for (size_t i = 0; i < sizeof(channel) / sizeof(channel[0]); i++)
+			channelCommands[channel[i]] = Server::findCommand(channel[i], strlen(channel[i]))->handler;
+	}
+
+	Server::CommandHandler find(const char *verb, size_t length)
+	{
+		std::string cmdName(verb, length);
+		for (size_t i = 0; i < cmdName.size(); i++)
+			cmdName[i] = toupper(cmdName[i]);
+		std::map<std::string, Server::CommandHandler>::iterator it = registrationCommands.find(cmdName);
+		if (it != registrationCommands.end())
+			return it->second;
+		it = channelCommands.find(cmdName);
+		return it != channelCommands.end() ? it->second : NULL;
+	}
+};
+
+/**
+ * @brief Dispatch cost over a command mix weighted like a chat server's traffic.
+ * @details Out of every 100 lines: 70 PRIVMSG (10 of them lowercase), 6 JOIN, 5 PART,
+ * 5 MODE, 3 TOPIC, 3 unknown (PING), 2 KICK, 2 NICK, 2 QUIT, 1 INVITE and 1 USER.
+ */
+static void benchDispatch(long iterations, size_t &sink)
+{
+	struct Weight
+	{
+		const char *verb;
+		int count;
+	};
+	const Weight mix[] = {
+		{"PRIVMSG", 60}, {"privmsg", 10}, {"JOIN", 6}, {"PART", 5}, {"MODE", 5}, {"TOPIC", 3},
+		{"PING", 3}, {"KICK", 2}, {"NICK", 2}, {"QUIT", 2}, {"INVITE", 1}, {"USER", 1}
+	};
+	std::vector<const char *> verbs;
+	for (size_t i = 0; i < sizeof(mix) / sizeof(mix[0]); i++)
+		verbs.insert(verbs.end(), mix[i].count, mix[i].verb);
+	for (size_t i = verbs.size() - 1; i > 0; i--) //fixed shuffle, so that the branches are not trivially predicted
+		std::swap(verbs[i], verbs[(i * 7919) % (i + 1)]);
+	std::vector<size_t> lengths;
+	for (size_t i = 0; i < verbs.size(); i++)
+		lengths.push_back(strlen(verbs[i]));
+
+	std::cout << "dispatch of a weighted mix of " << verbs.size() << " verbs" << std::endl;
+	MapDispatch maps;
+	long rounds = iterations / verbs.size();
+	unsigned long allocations = g_allocations;
+	double start = now();
+	for (long r = 0; r < rounds; r++)
+		for (size_t i = 0; i < verbs.size(); i++)
+			sink += maps.find(verbs[i], lengths[i]) != NULL;
+	report("std::map", now() - start, g_allocations - allocations, rounds * verbs.size());
+
+	allocations = g_allocations;
+	start = now();
+	for (long r = 0; r < rounds; r++)
+		for (size_t i = 0; i < verbs.size(); i++)
+			sink += Server::findCommand(verbs[i], lengths[i]) != NULL;
+	report("findCommand", now() - start, g_allocations - allocations, rounds * verbs.size());
+}
+
+int main(int ac, char **av)
+{
+	long iterations = ac > 1 ? atol(av[1]) : 1000000;
+	const char *lines[] = {
+		"PRIVMSG #channel :hello there, how is everyone doing today?",
+		"PRIVMSG alice,bob :are you coming to the meeting",
+		"JOIN #a,#b,#c key1,key2",
+		"MODE #channel +o alice",
+		"KICK #channel bob :flooding the channel",
+		"TOPIC #channel :release planning",
+		":alice!~alice@localhost PRIVMSG #channel :with a prefix",
+		"PING :irc.example.net"
+	};
+	size_t sink = 0;
+
+	benchFramer(sink);
+	for (size_t l = 0; l < sizeof(lines) / sizeof(lines[0]); l++)
+	{
+		std::string line(lines[l]);
+		std::cout << line << std::endl;
+
+		unsigned long allocations = g_allocations;
+		double start = now();
+		for (long i = 0; i < iterations; i++)
+			sink += split_cmd(line).size();
+		report("split_cmd", now() - start, g_allocations - allocations, iterations);
+
+		allocations = g_allocations;
+		start = now();
+		for (long i = 0; i < iterations; i++)
+		{
+			Message message;
+			message.parse(line.data(), line.size());
+			sink += message.paramCount();
+		}
+		report("Message::parse", now() - start, g_allocations - allocations, iterations);
+	}
+	benchDispatch(iterations, sink);
+	return sink == 0;
+}
@@ -0,0 +1,172 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <new>
+#include <sys/time.h>
+#include "messages.hpp"
+#include "ReplyBuilder.hpp"
+
+/**
+ * @file replies.cpp
+ * @brief Microbenchmark of the reply*() builders against the messages.hpp macros they replaced.
+ *
+ * @details For each of the hot replies, checks that both produce the same bytes, then
+ * builds it `iterations` times each way and prints the time and the heap allocations
+ * (operator new, counted below) per reply.
+ * Usage: replies [iterations]
+ */
+
+static unsigned long g_allocations = 0;
+
+void *operator new(size_t size) throw(std::bad_alloc)
+{
+	g_allocations++;
+	void *pointer = malloc(size ? size : 1);
+	if (!pointer)
+		throw std::bad_alloc();
+	return pointer;
+}
+
+void operator delete(void *pointer) throw()
+{
+	free(pointer);
+}
+
+static double now()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/**
+ * @brief Inputs of the replies, sized like the traffic of a busy channel.
+ */
+struct Fields
+{
+	std::string nick;
+	std::string user;
+	std::string source; //nick!~user@localhost, see Client::get_source()
+	std::string hostname; //nick!user, see Client::get_hostname()
+	std::string ip;
+	std::string channel;
+	std::string target;
+	std::string text;
+	std::string names;
+	std::string topic;
+	std::string reason;
+	std::string oldNick;
+	std::string modes;
+	std::string params;
+	std::string time;
+	Arena arena;
+	ArenaString arenaText;
+	ArenaString arenaModes;
+	ArenaString arenaParams;
+	ArenaString arenaCommand;
+
+	Fields() : nick("alice"), user("alice"), source("alice!~alice@localhost"), hostname("alice!alice"), ip("127.0.0.1"),
+		channel("#general"), target("bob"), text("did anyone look at the release notes before the meeting?"),
+		topic("release planning, see the notes"), reason("Leaving"), oldNick("alice_"), modes("+o"), params("bob"), time("18:4:27"),
+		arenaText(text.c_str(), ArenaAllocator<char>(arena)), arenaModes(modes.c_str(), ArenaAllocator<char>(arena)),
+		arenaParams(params.c_str(), ArenaAllocator<char>(arena)), arenaCommand("PING", ArenaAllocator<char>(arena))
+	{
+		for (int i = 0; i < 20; i++)
+			names += (i ? " " : "@") + std::string("member") + static_cast<char>('a' + i);
+	}
+};
+
+#define REPLY_COUNT 14
+
+static const char *g_names[REPLY_COUNT] = {
+	"PRIVMSG_CHANNEL", "PRIVMSG_USER", "USER_JOIN", "USER_PART", "NAMES_LIST",
+	"NAMES_END", "CHANNEL_TOPIC", "NICK_UPDATE", "QUIT", "MODE_CHANGE",
+	"NO_SET_TOPIC", "TOPIC_WHO_TIME", "WELCOME", "CMD_NOT_FOUND"
+};
+
+static std::string viaMacro(int reply, const Fields &f)
+{
+	switch (reply)
+	{
+		case 0: return MSG_PRIVMSG_CHANNEL(f.nick, f.user, f.channel, f.text);
+		case 1: return MSG_PRIVMSG_USER(f.nick, f.user, f.target, f.text);
+		case 2: return MSG_USER_JOIN(f.hostname, f.ip, f.channel);
+		case 3: return MSG_USER_PART(f.nick, f.user, f.ip, f.channel, f.reason);
+		case 4: return MSG_NAMES_LIST(f.nick, f.channel, f.names);
+		case 5: return MSG_NAMES_END(f.nick, f.channel);
+		case 6: return MSG_CHANNEL_TOPIC(f.nick, f.channel, f.topic);
+		case 7: return MSG_NICK_UPDATE(f.oldNick, f.nick);
+		case 8: return MSG_QUIT(f.nick, f.user, f.reason);
+		case 9: return MSG_MODE_CHANGE(f.nick, f.user, f.channel, f.modes, f.params);
+		case 10: return MSG_NO_SET_TOPIC(f.nick, f.channel);
+		case 11: return MSG_TOPIC_WHO_TIME(f.nick, f.channel, f.time);
+		case 12: return MSG_WELCOME(f.nick);
+		default: return ERROR_COMMAND_NOT_RECOGNIZED(f.nick, std::string("PING"));
+	}
+}
+
+static void viaBuilder(int reply, const Fields &f, ReplyBuilder &out)
+{
+	switch (reply)
+	{
+		case 0: replyPrivmsgChannel(out, f.source, f.channel, f.arenaText); break;
+		case 1: replyPrivmsgUser(out, f.nick, f.user, f.target, f.arenaText); break;
+		case 2: replyUserJoin(out, f.hostname, f.ip, f.channel); break;
+		case 3: replyUserPart(out, f.source, f.channel, f.reason); break;
+		case 4: replyNamesList(out, f.nick, f.channel, f.names); break;
+		case 5: replyNamesEnd(out, f.nick, f.channel); break;
+		case 6: replyChannelTopic(out, f.nick, f.channel, f.topic); break;
+		case 7: replyNickUpdate(out, f.oldNick, f.nick); break;
+		case 8: replyQuit(out, f.source, f.reason); break;
+		case 9: replyModeChange(out, f.source, f.channel, f.arenaModes, f.arenaParams); break;
+		case 10: replyNoSetTopic(out, f.nick, f.channel); break;
+		case 11: replyTopicWhoTime(out, f.nick, f.channel, f.time); break;
+		case 12: replyWelcome(out, f.nick); break;
+		default: replyCommandNotRecognized(out, f.nick, f.arenaCommand); break;
+	}
+}
+
+int main(int ac, char **av)
+{
+	long iterations = ac > 1 ? atol(av[1]) : 1000000;
+	Fields fields;
+	size_t sink = 0;
+
+	std::cout << "reply                  macro                      reply*() builder" << std::endl;
+	for (int r = 0; r < REPLY_COUNT; r++)
+	{
+		ReplyBuilder check;
+		viaBuilder(r, fields, check);
+		if (std::string(check.data(), check.size()) != viaMacro(r, fields))
+		{
+			std::cerr << g_names[r] << ": the builder and the macro differ" << std::endl;
+			return 1;
+		}
+
+		unsigned long allocations = g_allocations;
+		double start = now();
+		for (long i = 0; i < iterations; i++)
+			sink += viaMacro(r, fields).size();
+		double macroTime = now() - start;
+		unsigned long macroAllocations = g_allocations - allocations;
+
+		allocations = g_allocations;
+		start = now();
+		for (long i = 0; i < iterations; i++)
+		{
+			ReplyBuilder out;
+			viaBuilder(r, fields, out);
+			sink += out.size();
+		}
+		double builderTime = now() - start;
+		unsigned long builderAllocations = g_allocations - allocations;
+
+		std::cout << std::left << std::setw(17) << g_names[r] << std::right << std::fixed
+			<< std::setprecision(1) << std::setw(8) << macroTime / iterations * 1e9 << " ns"
+			<< std::setprecision(2) << std::setw(7) << static_cast<double>(macroAllocations) / iterations << " allocs"
+			<< std::setprecision(1) << std::setw(10) << builderTime / iterations * 1e9 << " ns"
+			<< std::setprecision(2) << std::setw(7) << static_cast<double>(builderAllocations) / iterations << " allocs" << std::endl;
+	}
+	return sink == 0;
+}
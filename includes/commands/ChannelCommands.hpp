@@ -7,6 +7,8 @@
 class Client;
 class Channel;
 class Server;
+class Message;
+struct ModeSpec;
 
 /*******************/
 /* Server Commands */
@@ -15,28 +17,25 @@ class Server;
 // This macro defines all Server command methods
 #define SERVER_COMMAND_METHODS \
 	/***JOIN Command***/ \
-	void	JOIN(std::string cmd, int fd); \
-	std::vector<std::pair<std::string, std::string> > SplitJOIN(std::string cmd); \
+	void	JOIN(const Message &msg, int fd); \
+	ArenaStringPairList SplitJOIN(const Message &msg); \
 	void	Channel_Exist(Channel *channel, Client *client, int fd, std::string key, std::string name); \
 	void	Channel_Not_Exist(std::string channel_name, Client *client, int fd); \
+	void	sendNames(Channel *channel, const std::string &name, Client *client, int fd); \
 	/***PART Command***/ \
-	void	PART(std::string cmd, int fd); \
-	std::vector<std::string> SplitPART(std::string cmd); \
+	void	PART(const Message &msg, int fd); \
 	/***PRIVMSG Command***/ \
-	void	PRIVMSG(std::string cmd, int fd); \
-	std::vector<std::string> SplitPM(std::string command); \
+	void	PRIVMSG(const Message &msg, int fd); \
+	ArenaStringList SplitPM(const Message &msg); \
 	/***TOPIC Command***/ \
-	void	TOPIC(std::string cmd, int fd); \
-	std::vector<std::string> SplitTopic(std::string cmd); \
+	void	TOPIC(const Message &msg, int fd); \
 	static std::string	getCurrentTime(); \
 	/***INVITE Command***/ \
-	void	INVITE(std::string cmd, int fd); \
+	void	INVITE(const Message &msg, int fd); \
 	/***KICK Command***/ \
-	void	KICK(std::string cmd, int fd); \
-	std::vector<std::string> SplitKICK(std::string cmd); \
+	void	KICK(const Message &msg, int fd); \
 	/***MODE Command***/ \
-	void	MODE(std::string cmd, int fd); \
-	std::vector<std::string> SplitMODE(std::string cmd); \
-	bool	isChannelValid(Channel *channel, std::string channel_string, std::string client_nick, int fd); \
-	bool	deactivateMode(Client *client,char mode, std::string parameter, Channel *channel); \
-	bool	activateMode(Client *client, char mode, std::string parameter, Channel *channel);
+	void	MODE(const Message &msg, int fd); \
+	ArenaStringList SplitMODE(const Message &msg); \
+	bool	isChannelValid(Channel *channel, std::string channel_string, std::string client_nick, int fd, unsigned int privilege); \
+	bool	applyMode(Channel *channel, const ModeSpec &spec, bool value, const ArenaString &parameter);
@@ -7,6 +7,7 @@
 class Client;
 class Channel;
 class Server;
+class Message;
 
 /*************************/
 /* Registration Commands */
@@ -14,8 +15,8 @@ class Server;
 
 // This macro defines all registration command methods
 #define REGISTRATION_COMMAND_METHODS \
-	void NICK(std::string cmd, int fd); \
-	void USER(std::string cmd, int fd); \
-	void PASS(std::string cmd, int fd); \
-	void QUIT(std::string cmd, int fd); \
-	std::string	SplitQUIT(std::string cmd); 
+	void NICK(const Message &msg, int fd); \
+	void USER(const Message &msg, int fd); \
+	void PASS(const Message &msg, int fd); \
+	void QUIT(const Message &msg, int fd); \
+	std::string	SplitQUIT(const Message &msg);
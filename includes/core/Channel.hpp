@@ -2,7 +2,9 @@
 #define CHANNEL_HPP
 
 #include "Server.hpp"
+#include "../utils/ReplyBuilder.hpp"
 #include <utility>
+#include <algorithm>
 #include <ctime>
 
 
@@ -10,24 +12,100 @@
 class Client;
 class Server;
 
+#define NAMES_NICK_RESERVE 30 //requester nickname length the cached 353 lines leave room for
+
+/**
+ * @brief Status bits of a channel member.
+ */
+enum MemberFlag
+{
+	MEMBER_OP = 1 << 0, //channel operator, "@" in NAMES
+	MEMBER_VOICE = 1 << 1 //voiced member, "+" in NAMES (MODE +v)
+};
+
+/**
+ * @brief Channel mode bits, all held by Channel::_modes.
+ */
+enum ChannelMode
+{
+	CHANMODE_INVITE_ONLY = 1 << 0, //+i, JOIN needs an invitation
+	CHANMODE_TOPIC_LOCK = 1 << 1, //+t, only operators change the topic
+	CHANMODE_KEY = 1 << 2, //+k, JOIN needs Channel::_password
+	CHANMODE_LIMIT = 1 << 3 //+l, JOIN fails once Channel::_limit members are in
+};
+
+/**
+ * @brief What a mode letter changes, i.e. how Server::applyMode() treats it.
+ */
+enum ModeKind
+{
+	MODEKIND_FLAG, //a ChannelMode bit and nothing else
+	MODEKIND_KEY, //CHANMODE_KEY and the channel key
+	MODEKIND_LIMIT, //CHANMODE_LIMIT and the user limit
+	MODEKIND_MEMBER //a MemberFlag bit of the member named by the parameter, not listed by get_activeModes()
+};
+
+/**
+ * @brief When a mode letter consumes a MODE parameter.
+ */
+enum ModeParam
+{
+	MODEPARAM_NONE,
+	MODEPARAM_ALWAYS, //on both '+' and '-' (k, o, v)
+	MODEPARAM_ON_SET //on '+' only (l)
+};
+
+/**
+ * @brief One entry of the mode descriptor table (see Channel::findMode()).
+ */
+struct ModeSpec
+{
+	char letter;
+	ModeKind kind;
+	unsigned int bit; //ChannelMode bit, or MemberFlag bit for MODEKIND_MEMBER
+	ModeParam param;
+	unsigned int privilege; //MemberFlag bits the setter needs, 0 for anyone in the channel
+};
+
+#define CHANNEL_MODE_COUNT 6 //entries of Channel::_modeTable
+
+/**
+ * @brief One channel membership: a reference to the client and its status in the channel.
+ * @note The client itself lives in Server::_clients, a membership never copies it.
+ * Its fd is kept apart, at the same index of Channel::_recipients.
+ */
+struct Member
+{
+	ClientHandle handle;
+	unsigned int flags; //MemberFlag bits
+};
+
 class Channel
 {
 	private:
 	Server* _server;
-	int _inviteOnly;
-	int _topic;
-	int _key;
-	int _limit;
-	bool _topicRestriction;
+	unsigned int _modes; //ChannelMode bits
+	std::string _activeModes; //"+itkl" form of _modes, rebuilt by set_mode()
+	int _limit; //user limit while CHANMODE_LIMIT is set
 	std::string _name;
 	std::string _timeCreation;
 	std::string _password;
 	std::string _createdAt;
 	std::string _topicName;
 	std::string _topicCreator;
-	std::vector<Client> _clients;
-	std::vector<Client> _admins;
-	std::vector<std::pair<char, bool> > _modes;
+	std::vector<Member> _members; //in join order
+	std::vector<int> _recipients; //fd of each member, same order as _members: all the fanout loops read
+	std::vector<std::string> _names; //cached 353 payloads, see get_names()
+	bool _namesValid; //false once a part, nick or status change made _names stale
+	std::vector<std::string> _namesScratch; //353 payloads built for a requester whose nickname is too long for _names
+
+	size_t namesBudget(size_t nickLength);
+	std::string namesEntry(size_t index);
+	void buildNames(std::vector<std::string> &chunks, size_t budget);
+	void fanout(const SharedBuffer &buffer);
+	void fanoutExcept(const SharedBuffer &buffer, int fd);
+	void fanout(const SharedBuffer &buffer, int fd, unsigned long epoch);
+	static const ModeSpec _modeTable[CHANNEL_MODE_COUNT];
 
 	public:
 	Channel();
@@ -39,57 +117,48 @@ class Channel
 	/*    Setters    */
 	/*****************/
 	void set_server(Server *server);
-	void set_inviteOnly(int invitation);
-	void set_topicMode(int topic);
 	void set_topicModificationTime(std::string time);
-	void set_keyMode(int key);
+	void set_mode(unsigned int mode, bool value);
 	void set_userLimit(int limit);
 	void set_topicName(std::string topic_name);
 	void set_topicCreator(std::string creator);
 	void set_password(std::string password);
 	void set_name(std::string name);
-	void set_topicRestriction(bool value);
-	void set_modeAtIndex(size_t index, bool mode);
 	void set_channelCreationTime();
 
 	/*****************/
 	/*    Getters    */
 	/*****************/
-	int get_invitOnly();
-	int get_topicMode();
-	int get_keyMode();
+	bool hasMode(unsigned int mode) const;
 	int get_userLimit(); // GetLimit
 	int get_totalUsers(); //antes GetClientsNumber
-	bool get_topicRestriction() const;
-	bool get_ModeAtIndex(size_t index);
-	bool isClientInChannel(std::string &nick);
+	bool isMember(int fd);
+	bool hasPrivilege(int fd, unsigned int privilege);
+	bool isOperator(int fd);
 	std::string get_topicName();
 	std::string get_topicCreator() const;
 	std::string get_password();
 	std::string get_name();
 	std::string get_topicModificationTime();
 	std::string get_channelCreationTime();
-	std::string get_memberList(); // clientChannel_list
-    std::string get_activeModes();
-	Client *get_clientByFd(int fd);
-	Client *get_adminByFd(int fd);
-	Client* get_clientByname(std::string name);
+	const std::vector<std::string> &get_names(size_t nickLength);
+	const std::string &get_activeModes() const;
+	Member *get_member(int fd);
+	static const ModeSpec *findMode(char letter);
 
 	/*****************/
 	/*    Methods    */
 	/*****************/
-	void add_client(Client newClient);
-	void add_admin(Client newClient);
-	void remove_client(int fd);
-	void remove_admin(int fd);
-	bool moveClientBetween(std::vector<Client> &from,
-		std::vector<Client> &to, const std::string &nick);
-	bool change_clientToAdmin(std::string& nick);
-	bool change_adminToClient(std::string& nick);
-	void broadcast_message(std::string reply);
-	void broadcast_message(std::string reply, std::set<int>& notified_fds);
-	void broadcast_messageExcept(std::string reply, int fd);
-	void broadcast_messageExcept(std::string reply, int fd, std::set<int>& notified_fds);
+	void add_member(Client &client, unsigned int flags);
+	void remove_member(int fd);
+	bool set_memberFlag(int fd, unsigned int flag, bool value);
+	void invalidateNames();
+	void broadcast_message(const std::string &reply);
+	void broadcast_message(const ReplyBuilder &reply);
+	void broadcast_message(const SharedBuffer &buffer, unsigned long epoch);
+	void broadcast_messageExcept(const std::string &reply, int fd);
+	void broadcast_messageExcept(const ReplyBuilder &reply, int fd);
+	void broadcast_messageExcept(const SharedBuffer &buffer, int fd, unsigned long epoch);
 };
 
 #endif
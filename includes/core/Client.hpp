@@ -2,23 +2,54 @@
 
 #include <iostream>
 #include <vector>
+#include <deque>
+#include <sys/uio.h>
+#include "../utils/SharedBuffer.hpp"
+#include "../utils/LineFramer.hpp"
+#include "ClientHandle.hpp"
+
+/**
+ * @brief Connection classes, each one with its own sendq byte limit (see Server::set_sendqLimit()).
+ */
+enum ClientClass
+{
+	CLASS_UNREGISTERED, //PASS/NICK/USER not completed yet
+	CLASS_USER, //registered and logged in
+	CLASS_COUNT
+};
 
 //forward declaration
 class Server;
+class Channel;
 
 class Client
 {
 	private:
 		int _fd;
+		ClientHandle _handle; //slot of this client in Server::_clients, referenced by channel memberships
 		std::string _IPaddress;
 		std::string _nickname;
 		std::string _username;
-		std::string _buffer;
+		std::string _source; //"nick!~user@localhost", prefix of the messages this client originates (see updatePrefixes())
+		std::string _hostname; //"nick!user", see get_hostname()
+		LineFramer _framer; //received bytes, split into lines for the parser
+		bool _readPending; //listed in the owner reactor's pendingReads (read budget ran out before EAGAIN)
 		std::vector<std::string> _channels;
-		std::vector<std::string> _cmd;
+		std::vector<Channel*> _joined; //channels this client is a member of (kept by Channel::add_member()/remove_member())
 		bool _logedIn; // Se usa???
 		bool _passRegistered;
 		bool _isQuitting;
+		std::deque<SharedBuffer> _sendQueue; //replies not yet accepted by the kernel, oldest first (shared with other recipients)
+		size_t _sendOffset; //bytes of _sendQueue.front() already sent by this client
+		size_t _sendInFlight; //front entries of _sendQueue handed to a writev() made without the server lock
+		size_t _sendQueueBytes; //unsent bytes across the whole queue
+		size_t _sendQueueHighWater; //largest _sendQueueBytes seen on this connection
+		bool _wantsWrite; //write interest currently enabled in poll/epoll
+		bool _flushScheduled; //already listed in the owner reactor's pendingFlush for this loop iteration
+		size_t _reactor; //index of the reactor (event loop thread) that accepted this client
+		unsigned long _fanoutStamp; //epoch of the last multi-channel fanout that reached this client, see Server::beginFanout()
+
+		void updatePrefixes();
 
 		//bool isOperator; //borrar si al final no la usamos
 
@@ -31,18 +62,29 @@ class Client
 		/******************/
 		/*     Getters    */
 		/******************/
-		std::string get_username() const;
-		std::string get_nickname() const;
-		std::string get_hostname() const;
+		const std::string &get_username() const;
+		const std::string &get_nickname() const;
+		const std::string &get_hostname() const;
+		const std::string &get_source() const;
 		std::string get_IPaddress() const;
 		int get_fd() const;
-		const std::string& get_buffer() const; //& porque no queremos que devuelva una copia sino un pointer
-		const std::vector<std::string>& get_cmd() const; //devuelve un pointer
+		ClientHandle get_handle() const;
 		const std::vector<std::string>& get_channels() const;  //devuelve un pointer
+		const std::vector<Channel*>& get_joinedChannels() const;
 		bool get_logedIn() const;
 		bool get_passRegistered() const;
 		bool get_channelInvitation(std::string &channel_name);
 		bool get_isQuitting() const;
+		size_t get_sendQueueBytes() const;
+		size_t get_sendQueueHighWater() const;
+		bool get_wantsWrite() const;
+		bool get_flushScheduled() const;
+		size_t get_reactor() const;
+		bool get_readPending() const;
+		size_t get_sendInFlight() const;
+		unsigned long get_fanoutStamp() const;
+		LineFramer &get_framer();
+		ClientClass get_class() const;
 
 
 		/******************/
@@ -52,16 +94,31 @@ class Client
 		void set_nickname(std::string nickname);
 		void set_IPaddress(const std::string& address);
 		void set_fd(int fd);
-		void set_buffer(const std::string& chunk);
-		void set_cmd(const std::vector<std::string>& cmds);
+		void set_handle(ClientHandle handle);
 		void set_passRegistered(const bool value);
 		void set_logedIn(const bool value);
 		void set_isQuitting(const bool value);
+		void set_wantsWrite(const bool value);
+		void set_flushScheduled(const bool value);
+		void set_reactor(size_t index);
+		void set_readPending(const bool value);
+		void set_sendInFlight(size_t entries);
+		void set_fanoutStamp(unsigned long epoch);
 
 		/******************/
 		/*      Utils     */
 		/******************/
-		void clearBuffer();
 		void addChannelInvitation(std::string channel_name);
 		void removeChannelInvitation(std::string &channel_name);
+		void addJoinedChannel(Channel *channel);
+		void removeJoinedChannel(Channel *channel);
+
+		/******************/
+		/*   Send queue   */
+		/******************/
+		bool enqueueResponse(const SharedBuffer &data, size_t limit);
+		void dropQueuedOutput();
+		bool hasPendingOutput() const;
+		int pendingIovecs(struct iovec *iov, int max) const;
+		void consumeOutput(size_t bytes);
 };
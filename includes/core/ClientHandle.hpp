@@ -0,0 +1,20 @@
+#pragma once
+
+/**
+ * @brief Names one client in a ClientSlab: a slot index plus the generation of that slot.
+ *
+ * @details A slot's generation is bumped every time its client is released, so a handle
+ * kept after the client left no longer matches and ClientSlab::get() returns NULL,
+ * even once the slot holds another client.
+ */
+struct ClientHandle
+{
+	unsigned int index;
+	unsigned int generation; //0 is never used by a live client: ClientHandle() is a null handle
+
+	ClientHandle();
+	ClientHandle(unsigned int index, unsigned int generation);
+	bool isNull() const;
+	bool operator==(ClientHandle const &other) const;
+	bool operator!=(ClientHandle const &other) const;
+};
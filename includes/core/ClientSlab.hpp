@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include "Client.hpp"
+#include "ClientHandle.hpp"
+
+#define CLIENT_SLAB_CHUNK 64 //clients allocated at once when the slab runs out of free slots
+
+/**
+ * @brief Pool of Client objects with stable addresses, addressed by generational handles.
+ *
+ * @details Clients live in chunks of CLIENT_SLAB_CHUNK that are never moved or freed
+ * before the slab itself, so a Client* stays valid for as long as the client is connected,
+ * whatever else connects or disconnects. acquire() and release() are O(1): released slots
+ * go to a free list and are reused first.
+ */
+class ClientSlab
+{
+	private:
+		std::vector<Client*> _chunks; //arrays of CLIENT_SLAB_CHUNK clients
+		std::vector<unsigned int> _generations; //current generation of each slot
+		std::vector<bool> _used; //slot holds a live client
+		std::vector<unsigned int> _free; //released slots, reused last in first out
+		size_t _size; //live clients
+
+		void clear();
+
+	public:
+		ClientSlab(); // Constructor
+		ClientSlab(ClientSlab const &copy); // Copy constructor
+		ClientSlab& operator=(ClientSlab const &copy); // Copy assignment operator
+		~ClientSlab(); // Destructor
+
+		ClientHandle acquire();
+		void release(ClientHandle handle);
+
+		/******************/
+		/*     Getters    */
+		/******************/
+		Client *get(ClientHandle handle);
+		Client *at(size_t index);
+		size_t capacity() const;
+		size_t size() const;
+};
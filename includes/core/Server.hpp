@@ -3,7 +3,6 @@
 #include <iostream>
 #include <vector>
 #include <map>
-#include <set>
 #include <sstream>
 #include <cstdlib>
 #include <unistd.h>
@@ -12,15 +11,25 @@
 #include <string>
 #include <csignal>
 #include <poll.h>
+#include <cerrno>
+#include <pthread.h>
+#ifdef __linux__
+# include <sys/epoll.h>
+# include <sys/eventfd.h>
+#endif
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
 
 #include "Client.hpp"
+#include "ClientSlab.hpp"
 #include "Channel.hpp"
 #include "../commands/ChannelCommands.hpp"
 #include "../commands/RegistrationCommands.hpp"
 #include "../utils/messages.hpp"
+#include "../utils/Message.hpp"
+#include "../utils/ReplyBuilder.hpp"
+#include "../utils/NickRegistry.hpp"
 
 #define GREEN	"\033[32m"
 #define RED  	"\033[31m"
@@ -31,8 +40,146 @@
 #define FORM    "\033[4m"
 #define RESET	"\033[0m"
 
+#define EPOLL_MAX_EVENTS 256 //ready events fetched per epoll_wait() call
+#define SENDQ_DEFAULT_UNREGISTERED 16384 //default sendq limit (bytes) of CLASS_UNREGISTERED
+#define SENDQ_DEFAULT_USER 1048576 //default sendq limit (bytes) of CLASS_USER
+#define FLUSH_MAX_IOVECS 64 //queued replies gathered by a single writev() call
+#define MAX_REACTOR_THREADS 64 //upper bound of --threads
+#define READ_CHUNK_SIZE 16384 //free bytes guaranteed in a client's read buffer before each recv()
+#define READ_BUDGET_PER_EVENT 65536 //bytes read from one client per readiness event before yielding to the others
+#define ACCEPT_MAX_PER_TICK 256 //connections accepted per listener wakeup before yielding to the other ready fds
+#define COMMAND_TABLE_SIZE 16 //slots of the command dispatch table, a power of two (see Server::findCommand())
+
+/**
+ * @brief Readiness notification mechanism used by Server::execute().
+ * @note BACKEND_EPOLL is only available on Linux; elsewhere poll() is always used.
+ */
+enum EventBackend
+{
+	BACKEND_POLL,
+	BACKEND_EPOLL
+};
+
+/**
+ * @brief How replies are written to the sockets.
+ */
+enum OutputFormat
+{
+	OUTPUT_COLOR, //each reply wrapped in YELLOW ... RESET, readable with nc (default)
+	OUTPUT_WIRE //replies sent exactly as built, for real IRC clients (--wire)
+};
+
+/**
+ * @brief Flags of a command dispatch table entry.
+ */
+enum CommandFlag
+{
+	CMD_NEEDS_REGISTRATION = 1 << 0 //only dispatched once PASS, NICK and USER are done
+};
+
+/**
+ * @brief Worst case cost of a command, counted per class in ServerMetrics.
+ */
+enum CommandCost
+{
+	COST_LIGHT, //only updates the sender (PASS, USER)
+	COST_DIRECT, //replies to at most a couple of clients (INVITE)
+	COST_FANOUT, //may queue a reply for every member of one or more channels
+	COST_COUNT
+};
+
 class Client;
 class Channel;
+class Server;
+
+/**
+ * @brief Server-wide counters, printed when the server stops.
+ */
+struct ServerMetrics
+{
+	unsigned long sendqExceeded; //clients disconnected because their send queue went over the class limit
+	unsigned long fanouts; //channel broadcasts
+	unsigned long fanoutRecipients; //replies queued by those broadcasts
+	unsigned long fanoutBytesSerialized; //bytes serialized (allocated and copied) by those broadcasts
+	unsigned long commands; //command lines handed to parser()
+	unsigned long commandsByCost[COST_COUNT]; //commands dispatched, indexed by CommandCost
+	unsigned long unknownCommands; //commands not found in the dispatch table
+	unsigned long repliesQueued; //replies queued; each one used to cost a send() syscall
+	unsigned long flushSyscalls; //writev() calls actually made to flush them
+	unsigned long accepts; //connections accepted
+	unsigned long acceptTicks; //listener wakeups that accepted at least one connection
+	unsigned long acceptMaxPerTick; //largest batch accepted by a single wakeup
+	unsigned long acceptCapHits; //wakeups that stopped at ACCEPT_MAX_PER_TICK
+	unsigned long acceptEmfile; //connections refused because the process ran out of fds
+	unsigned long reads; //recv() calls that returned data
+	unsigned long bytesRead; //bytes returned by those calls
+	unsigned long readBudgetHits; //readiness events that stopped at READ_BUDGET_PER_EVENT before EAGAIN
+	unsigned long linesTooLong; //lines dropped because they went over IRC_LINE_MAX
+	unsigned long bytesQueued; //reply bytes queued to clients, counted once per recipient
+	unsigned long colorBytes; //part of bytesQueued spent on the OUTPUT_COLOR wrapping, what --wire saves
+
+	ServerMetrics();
+};
+
+/**
+ * @brief One event loop: its own listening socket, epoll instance and thread.
+ *
+ * @details With --threads N the server runs N reactors. Each one owns a SO_REUSEPORT
+ * listener on the same port, so the kernel shards incoming connections between them,
+ * and every accepted client stays owned by the reactor that accepted it.
+ * Replies queued for a client owned by another reactor are listed in that reactor's
+ * pendingFlush and the owner is woken through wakeFd to flush them.
+ */
+struct Reactor
+{
+	size_t index; //position in Server::_reactors, stored in Client::_reactor
+	int listeningSocket;
+	int epollFd; //-1 with the poll backend
+	int wakeFd; //eventfd written by other reactors, -1 with the poll backend
+	bool wakePending; //wakeFd already signalled and not drained yet
+	bool started; //thread created (reactor 0 runs on the main thread)
+	pthread_t thread;
+	std::vector<int> pendingFlush; //owned fds with replies queued during the current iteration
+	std::vector<int> pendingReads; //owned fds whose read budget ran out, read again on the next iteration
+	std::vector<int> pendingClose; //owned fds flagged as quitting, closed at the end of the iteration
+	std::vector<Client*> clients; //owned clients indexed by fd, only used by this reactor's thread (read without _lock)
+	unsigned long reads; //recv() calls made without _lock since they were last added to ServerMetrics
+	unsigned long bytesRead; //bytes returned by those calls
+	unsigned long readBudgetHits; //read budgets that ran out since then
+	Arena arena; //temporaries of the commands handled during the iteration, reset at its end
+	Server *server;
+
+	Reactor();
+};
+
+/**
+ * @brief One writev() prepared under Server::_lock and made without it (see Server::runReactor()).
+ */
+struct PendingWrite
+{
+	Client *client;
+	int fd;
+	size_t firstIovec; //position of its iovecs in the reactor's iovec array
+	int iovecCount;
+	size_t bytes; //total length of those iovecs
+	ssize_t sent; //writev() result
+	int error; //errno of a failed writev()
+};
+
+/**
+ * @brief RAII guard for a pthread mutex, released even when a command handler throws.
+ */
+class ScopedLock
+{
+	private:
+		pthread_mutex_t &_mutex;
+		ScopedLock(ScopedLock const &copy);
+		ScopedLock& operator=(ScopedLock const &copy);
+
+	public:
+		explicit ScopedLock(pthread_mutex_t &mutex);
+		~ScopedLock();
+};
 
 
 class Server
@@ -48,51 +195,130 @@ class Server
 		/******************/
 		void init();
 		void execute();
+		void executePoll();
+		void executeEpoll();
+		void runReactor(Reactor *reactor);
+		static void *reactorThread(void *arg);
+		void stopReactors();
+		int createListeningSocket(bool reusePort);
 		void NewClient();
+		int acceptConnection(int listeningSocket, struct sockaddr_in &clientAddr, socklen_t &addrLen);
+		bool shedConnection();
+		void addClient(int clientSocket, const struct sockaddr_in &clientAddr);
 		void NewData(int clientFd);
-		void parser(const std::string &command, int fd);
-		std::vector<std::string> split_receivedBuffer(std::string buffer);
+		bool receiveData(Reactor *reactor, Client *client);
+		void parseLines(int clientFd);
+		void parser(const char *line, size_t length, int fd);
 
 
 		/******************/
 		/*     Getters    */
 		/******************/
 		Client* get_client(int fd);
+		Client* get_clientByHandle(ClientHandle handle);
 		Client *get_clientNick(std::string nickname);
 		Channel* get_channelByName(const std::string& name);
+		EventBackend get_backend() const;
+		OutputFormat get_output() const;
+		bool get_trace() const;
+		size_t get_threads() const;
+		size_t get_sendqLimit(ClientClass clientClass) const;
+		const ServerMetrics &get_metrics() const;
+		Arena &get_arena();
+
+
+		/******************/
+		/*     Setters    */
+		/******************/
+		void set_backend(EventBackend backend);
+		void set_output(OutputFormat output);
+		void set_trace(bool value);
+		void set_threads(size_t count);
+		void set_sendqLimit(ClientClass clientClass, size_t bytes);
 
 
 		/******************/
 		/*      Utils     */
 		/******************/
 		static void signalHandler(int sig);
-		std::vector<std::string> split_cmd(std::string &cmd);
 		void _sendResponse(std::string response, int fd);
+		SharedBuffer formatReply(const std::string &response);
+		SharedBuffer formatReply(const ReplyBuilder &reply);
+		SharedBuffer serializeReply(const char *bytes, size_t length);
+		void sendReply(const ReplyBuilder &reply, int fd);
+		void sendBuffer(const SharedBuffer &buffer, int fd);
+		void recordFanout(const SharedBuffer &buffer, size_t recipients);
+		unsigned long beginFanout();
+		void flushSendQueue(Client *client);
+		void scheduleFlush(Client *client);
+		void scheduleRead(Client *client);
+		void scheduleClose(Client *client);
+		void flushPendingClients();
+		void prepareWrites(Reactor *reactor, const std::vector<int> &writable, std::vector<PendingWrite> &writes, std::vector<struct iovec> &iovecs);
+		void prepareWrite(Client *client, std::vector<PendingWrite> &writes, std::vector<struct iovec> &iovecs);
+		static void performWrites(std::vector<PendingWrite> &writes, std::vector<struct iovec> &iovecs);
+		bool completeWrites(std::vector<PendingWrite> &writes);
+		void addReadCounters(Reactor *reactor);
+		void setWriteInterest(Client *client, bool enable);
+		void sendqExceeded(Client *client);
+		void printMetrics() const;
 		bool isregistered(int fd); //old name: notregistered
 		void ft_close(int Fd);
 		void RemoveFd(int Fd);
+		void watchFd(Reactor *reactor, int fd, bool edgeTriggered);
+		void wakeReactor(Reactor *reactor);
+		void closeQuittingClients();
+		void closeClients(std::vector<int> &closing);
 		void RemoveClient(int clientFd);
 		void RemoveClientFromChannel(int fd);
 		void RemoveChannel(std::string &name);
-		std::string normalize_param(const std::string &s, bool flag);
-		void addChannel(Channel newChannel);
+		Channel *addChannel(const std::string &name);
+		void copyChannels(Server const &copy);
 
 
 		/******************/
 		/*    Commands    */
 		/******************/
-		typedef void (Server::*CommandHandler)(std::string, int);
+		typedef void (Server::*CommandHandler)(const Message &, int);
+
+		/**
+		 * @brief One slot of the command dispatch table.
+		 */
+		struct CommandSpec
+		{
+			const char *name; //uppercase verb, NULL for an empty slot
+			CommandHandler handler;
+			unsigned int flags; //CommandFlag bits
+			size_t maxParams; //parameters the handler takes, see Message::limitParams()
+			CommandCost cost;
+		};
+
+		static const CommandSpec *findCommand(const char *verb, size_t length);
 		SERVER_COMMAND_METHODS
 		REGISTRATION_COMMAND_METHODS
 
 	private:
-		static bool _signalRecieved; //old name: Signal
+		static volatile sig_atomic_t _signalRecieved; //old name: Signal. Set by signalHandler(), only read by the main thread
+		bool _stopping; //guarded by _lock: tells every reactor to return (see stopReactors())
 		int _port; //old name: port
 		std::string _pass; //old name: password
 		int _listeningSocket; //old name: server_fdsocket
+		EventBackend _backend;
+		OutputFormat _output;
+		bool _trace; //mirror every reply, colored, on stdout (--trace)
+		size_t _threads; //reactors started by init() with the epoll backend
+		std::vector<Reactor*> _reactors;
+		Reactor *_current; //reactor holding _lock, i.e. the one handling the current event
+		pthread_mutex_t _lock; //guards clients, channels, send queues and metrics across reactors
+		int _reserveFd; //spare fd released to shed connections on EMFILE (see shedConnection())
+		size_t _sendqLimits[CLASS_COUNT]; //max unsent bytes per client, indexed by ClientClass
+		ServerMetrics _metrics;
+		unsigned long _fanoutEpoch; //last epoch handed out by beginFanout()
 		std::vector<struct pollfd> _fds; //old name: fds        //este array incluye todos los Fd de clientes conectados y del _listeningSocket
-		std::vector<Client> _clients; //old name: clients   // Manejar la lista de clientes conectados. este array incluye todos los objetos clientes que tienen info
-		std::vector<Channel> _channels;
-		std::map<std::string, CommandHandler> _registrationCommands;
-  		std::map<std::string, CommandHandler> _channelCommands;
+		ClientSlab _clients; //old name: clients   // Manejar la lista de clientes conectados. este array incluye todos los objetos clientes que tienen info
+		std::vector<ClientHandle> _clientSlots; //indexed by fd: handle of its client in _clients, null if none (see get_client())
+		NickRegistry _nicks; //nickname -> fd of every client that chose a nick (see get_clientNick())
+		typedef std::tr1::unordered_map<std::string, Channel*, IrcCaseHash, IrcCaseEqual> ChannelMap;
+		ChannelMap _channels; //channel name (RFC 1459 case mapping) -> heap allocated channel, its address never changes
+		static const CommandSpec _commandTable[COMMAND_TABLE_SIZE];
 };
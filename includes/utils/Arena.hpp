@@ -0,0 +1,111 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#define ARENA_CHUNK_SIZE 16384 //bytes of an arena chunk; a larger request gets a chunk of its own size
+#define ARENA_ALIGN 16 //alignment of every arena allocation, enough for any scalar type
+
+/**
+ * @brief Bump allocator for the temporaries of one event loop iteration.
+ *
+ * @details Command handlers split their parameters into short-lived strings and vectors
+ * that all die before the loop goes back to poll()/epoll_wait(). Backed by an Arena
+ * (see ArenaAllocator), they cost a pointer bump instead of a malloc()/free() pair:
+ * - allocate() carves the next bytes out of the current chunk, or moves to the next one
+ * - deallocate is a no-op, the memory is only reclaimed by reset()
+ * - reset() rewinds to the first chunk and keeps every chunk for the next iteration,
+ *   so once the arena has grown to the busiest iteration it never calls malloc() again
+ *
+ * @note Not thread-safe: each reactor owns one (see Reactor::arena)
+ */
+class Arena
+{
+	private:
+		struct Chunk
+		{
+			char *data;
+			size_t size;
+		};
+		std::vector<Chunk> _chunks;
+		size_t _current; //chunk being filled
+		size_t _used; //bytes of _chunks[_current] already handed out
+		size_t _reserved; //bytes of all the chunks
+
+		Arena(Arena const &copy);
+		Arena& operator=(Arena const &copy);
+
+	public:
+		Arena(); // Constructor
+		~Arena(); // Destructor
+
+		/******************/
+		/*     Getters    */
+		/******************/
+		size_t get_reserved() const;
+
+		/******************/
+		/*      Utils     */
+		/******************/
+		void *allocate(size_t bytes);
+		void reset();
+};
+
+/**
+ * @brief Standard allocator handing out memory from an Arena, for the std containers.
+ * @note deallocate() does nothing: the arena frees everything at once on reset()
+ */
+template <class T>
+class ArenaAllocator
+{
+	private:
+		Arena *_arena;
+
+	public:
+		typedef T value_type;
+		typedef T *pointer;
+		typedef const T *const_pointer;
+		typedef T &reference;
+		typedef const T &const_reference;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+
+		template <class U>
+		struct rebind
+		{
+			typedef ArenaAllocator<U> other;
+		};
+
+		explicit ArenaAllocator(Arena &arena) : _arena(&arena) {} // Constructor
+		ArenaAllocator(ArenaAllocator const &copy) : _arena(copy._arena) {} // Copy constructor
+		template <class U>
+		ArenaAllocator(ArenaAllocator<U> const &copy) : _arena(copy.get_arena()) {}
+		ArenaAllocator& operator=(ArenaAllocator const &copy) {_arena = copy._arena; return (*this);} // Copy assignment operator
+		~ArenaAllocator() {} // Destructor
+
+		Arena *get_arena() const {return _arena;}
+		pointer address(reference value) const {return &value;}
+		const_pointer address(const_reference value) const {return &value;}
+		size_type max_size() const {return static_cast<size_type>(-1) / sizeof(T);}
+
+		pointer allocate(size_type count, const void * = 0)
+		{
+			return static_cast<pointer>(_arena->allocate(count * sizeof(T)));
+		}
+		void deallocate(pointer, size_type) {}
+		void construct(pointer place, const T &value) {new (static_cast<void *>(place)) T(value);}
+		void destroy(pointer place) {place->~T();}
+};
+
+template <class T, class U>
+bool operator==(ArenaAllocator<T> const &a, ArenaAllocator<U> const &b) {return a.get_arena() == b.get_arena();}
+template <class T, class U>
+bool operator!=(ArenaAllocator<T> const &a, ArenaAllocator<U> const &b) {return a.get_arena() != b.get_arena();}
+
+typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char> > ArenaString;
+typedef std::vector<ArenaString, ArenaAllocator<ArenaString> > ArenaStringList;
+typedef std::pair<ArenaString, ArenaString> ArenaStringPair;
+typedef std::vector<ArenaStringPair, ArenaAllocator<ArenaStringPair> > ArenaStringPairList;
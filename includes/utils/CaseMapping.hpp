@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+/**
+ * @brief RFC 1459 case mapping of nicknames and channel names.
+ *
+ * @details Besides A-Z / a-z, RFC 1459 section 2.2 treats "[]\~" as the uppercase
+ * forms of "{}|^" (Scandinavian origin), so "Bob[m]" and "bob{m}" are the same nick.
+ * Folding goes through a 256-entry lookup table, one load per byte.
+ */
+unsigned char ircFoldChar(unsigned char c);
+std::string ircCasefold(const std::string &name);
+bool ircCaseEqual(const std::string &a, const std::string &b);
+
+/**
+ * @brief Hash functor of case folded names, for std::tr1::unordered_map keys.
+ * @note Hashes on the fly: a lookup never builds a folded copy of the key
+ */
+struct IrcCaseHash
+{
+	size_t operator()(const std::string &name) const;
+};
+
+/**
+ * @brief Equality functor matching IrcCaseHash.
+ */
+struct IrcCaseEqual
+{
+	bool operator()(const std::string &a, const std::string &b) const;
+};
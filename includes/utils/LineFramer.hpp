@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#define IRC_LINE_MAX 512 //RFC 1459: a message never exceeds 512 bytes, "\r\n" included
+
+/**
+ * @brief Incremental splitter of a byte stream into IRC lines.
+ *
+ * @details recv() writes straight into the framer (writeSpace() / commit()) and next()
+ * hands out complete lines as views into the same storage, in a single pass:
+ * - A scan cursor remembers how far the incomplete tail was already searched for "\n",
+ *   so bytes are never scanned twice, however many reads a line is split into
+ * - Lines end with "\r\n" or a bare "\n", the terminator is not part of the view
+ * - An incomplete tail is kept across reads; the storage is reused, compacted only when
+ *   the tail needs the room, and grows only when the tail itself does
+ * - A line longer than the limit is dropped up to its terminator and reported once as
+ *   LINE_TOO_LONG; next() drops its bytes as it scans them, so the storage holds at most
+ *   the limit plus whatever was committed since the previous next() call. The server reads
+ *   up to READ_BUDGET_PER_EVENT bytes before parsing, which bounds it at about 64 KB per client
+ *
+ * @note Views stay valid until the next writeSpace() call
+ */
+class LineFramer
+{
+	public:
+		enum Status
+		{
+			LINE_NONE, //no complete line buffered
+			LINE_COMPLETE, //line and length describe the next line
+			LINE_TOO_LONG //a line went over the limit and was dropped
+		};
+
+	private:
+		std::vector<char> _buffer;
+		size_t _start; //first byte of the next line
+		size_t _scan; //bytes in [_start, _scan) are known not to contain "\n"
+		size_t _end; //end of the received bytes
+		size_t _maxLine; //maximum line length, terminator included
+		bool _discarding; //the current line went over the limit, its bytes are dropped until "\n"
+
+	public:
+		explicit LineFramer(size_t maxLine = IRC_LINE_MAX); // Constructor
+		LineFramer(LineFramer const &copy); // Copy constructor
+		LineFramer& operator=(LineFramer const &copy); // Copy assignment operator
+		~LineFramer(); // Destructor
+
+		/******************/
+		/*     Getters    */
+		/******************/
+		size_t buffered() const;
+
+		/******************/
+		/*      Utils     */
+		/******************/
+		char *writeSpace(size_t minimum, size_t &available);
+		void commit(size_t bytes);
+		Status next(const char *&line, size_t &length);
+};
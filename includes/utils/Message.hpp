@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "Arena.hpp"
+
+#define MESSAGE_MAX_PARAMS 15 //RFC 1459: at most 15 parameters, the trailing one included
+
+/**
+ * @brief One IRC line parsed in place: prefix, command and parameters as views into the line.
+ *
+ * @details parse() walks the line once and only records offset/length pairs, nothing is
+ * copied or allocated. The grammar follows RFC 1459 section 2.3.1:
+ *   [":" prefix SPACE] command {SPACE param} [SPACE ":" trailing]
+ * - Parameters are separated by one or more spaces
+ * - A parameter starting with ':' is the trailing one and runs until the end of the line
+ * - The 15th parameter always runs until the end of the line
+ * - limitParams() lowers that limit to what the command takes
+ * Handlers copy out (param(), paramList()) only what they keep, into the reactor's Arena
+ * for what dies with the command.
+ *
+ * @note The views point into the caller's line, which must outlive the Message
+ */
+class Message
+{
+	public:
+		struct Span
+		{
+			size_t offset;
+			size_t length;
+		};
+
+	private:
+		const char *_line;
+		size_t _length;
+		Span _prefix; //length 0 when the line has no prefix
+		Span _command;
+		Span _params[MESSAGE_MAX_PARAMS];
+		size_t _paramCount;
+		bool _hasTrailing; //the last parameter was introduced by ':' (it may be empty or contain spaces)
+
+	public:
+		Message(); // Constructor
+		Message(Message const &copy); // Copy constructor
+		Message& operator=(Message const &copy); // Copy assignment operator
+		~Message(); // Destructor
+
+		bool parse(const char *line, size_t length);
+		void limitParams(size_t max);
+
+		/******************/
+		/*     Getters    */
+		/******************/
+		std::string prefix() const;
+		std::string command() const;
+		size_t commandLength() const;
+		const char *commandData() const;
+		size_t paramCount() const;
+		bool hasTrailing() const;
+		std::string param(size_t index) const;
+		ArenaString param(size_t index, Arena &arena) const;
+		std::string paramOr(size_t index, const std::string &fallback) const;
+		const char *paramData(size_t index) const;
+		size_t paramLength(size_t index) const;
+		ArenaStringList paramList(size_t index, Arena &arena) const;
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <tr1/unordered_map>
+
+#include "CaseMapping.hpp"
+
+/**
+ * @brief Nickname to client fd map, under the RFC 1459 case mapping.
+ *
+ * @details Hashed on the case folded nick (IrcCaseHash / IrcCaseEqual), so lookups,
+ * inserts, renames and removals are O(1) and "Bob" and "bob" are the same entry.
+ * Keys keep the nick as the client chose it.
+ */
+class NickRegistry
+{
+	private:
+		typedef std::tr1::unordered_map<std::string, int, IrcCaseHash, IrcCaseEqual> Map;
+		Map _nicks;
+
+	public:
+		NickRegistry(); // Constructor
+		NickRegistry(NickRegistry const &copy); // Copy constructor
+		NickRegistry& operator=(NickRegistry const &copy); // Copy assignment operator
+		~NickRegistry(); // Destructor
+
+		int find(const std::string &nick) const;
+		void rename(const std::string &oldNick, const std::string &newNick, int fd);
+		void remove(const std::string &nick, int fd);
+		size_t size() const;
+};
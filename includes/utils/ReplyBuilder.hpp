@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include "Arena.hpp"
+
+#define REPLY_INLINE_MAX 1024 //bytes formatted without touching the heap; a 512-byte line plus a long nick!user prefix fits
+
+/**
+ * @brief Single pass formatter for the hot replies of messages.hpp.
+ *
+ * @details The messages.hpp macros chain up to a dozen std::string operator+ calls,
+ * each of them allocating a temporary. A ReplyBuilder appends every fragment in place:
+ * - The bytes go to a fixed buffer that lives with the builder (usually on the stack)
+ * - Constant fragments are string literals whose length is known at compile time
+ * - A reply that outgrows REPLY_INLINE_MAX moves to a std::string and keeps going
+ *
+ * The reply*() functions below produce the same bytes as the macro of the same name.
+ * Those taking a source expect Client::get_source(), i.e. what the macro builds from
+ * the nickname and username.
+ * @see Server::formatReply(const ReplyBuilder &) to turn the result into a SharedBuffer
+ */
+class ReplyBuilder
+{
+	private:
+		char _inline[REPLY_INLINE_MAX];
+		size_t _length;
+		std::string _spill; //holds the whole reply once it outgrew _inline, empty before that
+
+	public:
+		ReplyBuilder(); // Constructor
+		ReplyBuilder(ReplyBuilder const &copy); // Copy constructor
+		ReplyBuilder& operator=(ReplyBuilder const &copy); // Copy assignment operator
+		~ReplyBuilder(); // Destructor
+
+		/******************/
+		/*     Getters    */
+		/******************/
+		const char *data() const;
+		size_t size() const;
+
+		/******************/
+		/*      Utils     */
+		/******************/
+		ReplyBuilder &append(const char *bytes, size_t length);
+		ReplyBuilder &operator<<(const std::string &text);
+		ReplyBuilder &operator<<(const ArenaString &text);
+
+		/**
+		 * @brief Appends a string literal, its length is a compile time constant.
+		 * @note Meant for literals only: a char array is taken whole, up to its last byte
+		 */
+		template <size_t N>
+		ReplyBuilder &operator<<(const char (&literal)[N])
+		{
+			return append(literal, N - 1);
+		}
+};
+
+/******************/
+/*  Hot replies   */
+/******************/
+void replyPrivmsgChannel(ReplyBuilder &out, const std::string &source, const std::string &target, const ArenaString &message);
+void replyPrivmsgUser(ReplyBuilder &out, const std::string &nickname, const std::string &user, const std::string &target, const ArenaString &message);
+void replyUserJoin(ReplyBuilder &out, const std::string &hostname, const std::string &ipaddress, const std::string &channelname);
+void replyUserPart(ReplyBuilder &out, const std::string &source, const std::string &channelname, const std::string &reason);
+void replyNamesList(ReplyBuilder &out, const std::string &nickname, const std::string &channelname, const std::string &clientslist);
+void replyNamesEnd(ReplyBuilder &out, const std::string &nickname, const std::string &channelname);
+void replyChannelTopic(ReplyBuilder &out, const std::string &nickname, const std::string &channelname, const std::string &topic);
+void replyNoSetTopic(ReplyBuilder &out, const std::string &nickname, const std::string &channelname);
+void replyTopicWhoTime(ReplyBuilder &out, const std::string &nickname, const std::string &channelname, const std::string &creationtime);
+void replyNickUpdate(ReplyBuilder &out, const std::string &oldnickname, const std::string &nickname);
+void replyQuit(ReplyBuilder &out, const std::string &source, const std::string &reason);
+void replyModeChange(ReplyBuilder &out, const std::string &source, const std::string &channelname, const ArenaString &modes, const ArenaString &params);
+void replyKickUser(ReplyBuilder &out, const std::string &source, const std::string &channelname, const std::string &target);
+void replyKickUserReason(ReplyBuilder &out, const std::string &source, const std::string &channelname, const std::string &target, const std::string &reason);
+void replyWelcome(ReplyBuilder &out, const std::string &nickname);
+void replyCommandNotRecognized(ReplyBuilder &out, const std::string &nickname, const ArenaString &command);
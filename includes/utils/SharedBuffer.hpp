@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+#define SHARED_BUFFER_POOLED_SIZE 1024 //bytes of a pooled block: any reply of a 512-byte line, with a long prefix
+#define SHARED_BUFFER_POOL_MAX 4096 //released pooled blocks kept for reuse, about 4 MB; the others go back to the heap
+
+/**
+ * @brief Immutable, reference-counted byte buffer.
+ *
+ * @details A reply is serialized once into a SharedBuffer and the same bytes are then
+ * queued for every recipient: copying a SharedBuffer only increments a counter.
+ * Each recipient keeps its own send offset (see Client::_sendOffset), the bytes
+ * themselves are never modified after construction.
+ *
+ * The counter, the length and the bytes share one allocation. Blocks of up to
+ * SHARED_BUFFER_POOLED_SIZE bytes all have that capacity and go, once released, to a free
+ * list that the next buffer reuses: once the list holds as many blocks as the busiest moment
+ * had replies in flight, serializing a reply no longer calls malloc() or free().
+ *
+ * @note Not thread-safe: the reference count is a plain integer and the free list is shared
+ *       by every buffer. The server only creates, copies and releases them with _lock held.
+ */
+class SharedBuffer
+{
+	private:
+		struct Block
+		{
+			size_t refs;
+			size_t size;
+			size_t capacity;
+			Block *next; //next released block, while in the free list
+		};
+		Block *_block;
+
+		static Block *_pool; //released blocks of SHARED_BUFFER_POOLED_SIZE bytes
+		static size_t _pooled; //blocks in _pool
+
+		void assign(const char *bytes, size_t length);
+		void release();
+
+	public:
+		SharedBuffer(); // Constructor (empty buffer)
+		explicit SharedBuffer(const std::string &bytes);
+		SharedBuffer(const char *bytes, size_t length);
+		SharedBuffer(SharedBuffer const &copy); // Copy constructor
+		SharedBuffer& operator=(SharedBuffer const &copy); // Copy assignment operator
+		~SharedBuffer(); // Destructor
+
+		/******************/
+		/*     Getters    */
+		/******************/
+		const char *data() const;
+		size_t size() const;
+		bool empty() const;
+		size_t use_count() const;
+};
@@ -40,6 +40,7 @@
 #define ERROR_INVALID_NICKNAME(nickname) (":ft_irc 432 " + nickname + " :Invalid nickname format" + CRLF)
 #define ERROR_NOT_REGISTERED_YET(nickname) (":ft_irc 451 " + nickname + " :Registration required!" + CRLF)
 #define ERROR_COMMAND_NOT_RECOGNIZED(nickname, command) (":ft_irc 421 " + nickname + " " + command + " :Command not found" + CRLF)
+#define ERROR_INPUT_TOO_LONG(nickname) (":ft_irc 417 " + nickname + " :Input line was too long" + CRLF)
 #define ERROR_TOO_MANY_TARGETS(nickname) (":ft_irc 407 " + nickname + " :Too many channels" + CRLF)
 #define ERROR_IN_TOO_MANY_CHANNELS(nickname) (":ft_irc 405 " + nickname + " :You have joined too many channels" + CRLF)
 #define ERROR_WRONG_KEY(nickname, channelname) (":ft_irc 475 " + nickname + " #" + channelname + " :Incorrect password for channel" + CRLF)
@@ -50,4 +51,5 @@
 #define ERROR_ALREADY_IN_CHANNEL(nick, chan) (":ft_irc 443 " + nick + " " + chan + " :is already on this channel" + CRLF)
 #define ERROR_NO_TEXT_TO_SEND(nick) (":ft_irc 412 " + nick + " :No text to send" + CRLF)
 #define ERROR_NO_RECIPIENT(nickname) (":ft_irc 411 " + nickname + " :No recipient given (PRIVMSG)" + CRLF)
+#define ERROR_SENDQ_EXCEEDED() (std::string("ERROR :SendQ exceeded") + CRLF)
 #define ERROR_NO_ACTIVE_MODE()
@@ -1,12 +1,12 @@
 #include "../../includes/core/Server.hpp"
 
 /**
- * @brief Parses JOIN command parameters into channel-key pairs.
- * @param cmd The complete JOIN command string received from the client
- * @return std::vector<std::pair<std::string, std::string>> Vector of channel-key pairs
+ * @brief Pairs the channels and keys of the parsed JOIN parameters.
+ * @param msg The parsed JOIN message received from the client
+ * @return ArenaStringPairList Channel-key pairs, held by the reactor's arena
  *
  * @details Parses the JOIN command syntax which supports multiple channels and keys:
- * - Splits the command by spaces to extract channels and keys
+ * - The first parameter holds the channels, the optional second one the keys
  * - Handles comma-separated channel lists (e.g., "#chan1,#chan2")
  * - Handles comma-separated key lists (e.g., "key1,key2")
  * - Pairs each channel with its corresponding key (empty string if no key)
@@ -15,45 +15,23 @@
  * @note Keys are optional and will be paired with channels by index order
  * @see RFC 2812 Section 3.2.1 for JOIN command syntax specifications
  */
-std::vector<std::pair<std::string, std::string> > Server::SplitJOIN(std::string cmd)
+ArenaStringPairList Server::SplitJOIN(const Message &msg)
 {
-	// Split by spaces
-	std::vector<std::string> args = split_cmd(cmd); //Output: ["JOIN", "#chan1,#chan2", "key1,key2"]
-
-	if (args.size() < 2)
-		return (std::vector<std::pair<std::string, std::string> >());
+	Arena &arena = get_arena();
+	ArenaStringPairList result = ArenaStringPairList(ArenaAllocator<ArenaStringPair>(arena));
+	// Params: ["#chan1,#chan2", "key1,key2"]
+	if (msg.paramCount() < 1)
+		return (result);
 
 	// Split channels and keys (if existing) by comas
-	std::string channels_part = args[1]; // "#chan1,#chan2"
-	std::istringstream channel_stream(channels_part);
-	std::string single_channel;
-	std::vector<std::string> channels;
-
-	while (std::getline(channel_stream, single_channel, ','))
-		channels.push_back(single_channel); // channels = ["#chan1", "#chan2"]
-
-	std::vector<std::string> keys;
-	if (args.size() > 2)
-	{
-		std::string keys_part = args[2]; // "key1,key2"
-		std::istringstream key_stream(keys_part);
-		std::string single_key;
-
-		while (std::getline(key_stream, single_key, ','))
-			keys.push_back(single_key); // keys = ["key1", "key2"]
-	}
+	ArenaStringList channels = msg.paramList(0, arena); // channels = ["#chan1", "#chan2"]
+	ArenaStringList keys = msg.paramList(1, arena); // keys = ["key1", "key2"]
 
 	// Pair up
-	std::vector<std::pair<std::string, std::string> > result;
+	result.reserve(channels.size());
+	ArenaString noKey = ArenaString(ArenaAllocator<char>(arena)); // Default no key
 	for (size_t i = 0; i < channels.size(); i++)
-	{
-		std::string channel = channels[i];
-		std::string key = ""; // Default no key
-
-		if (i < keys.size())
-			key = keys[i];
-		result.push_back(std::make_pair(channel, key)); // result = [{"#chan1", "key1"}, {"#chan2", "key2"}]
-	}
+		result.push_back(ArenaStringPair(channels[i], i < keys.size() ? keys[i] : noKey)); // result = [{"#chan1", "key1"}, {"#chan2", "key2"}]
 	return (result);
 }
 
@@ -82,33 +60,27 @@ std::vector<std::pair<std::string, std::string> > Server::SplitJOIN(std::string
 void	Server::Channel_Exist(Channel *channel, Client *client, int fd, std::string key, std::string name)
 {
 	// Check if user is already in the channel
-	if (channel->get_clientByFd(fd) || channel->get_adminByFd(fd))
+	if (channel->isMember(fd))
 	{
 		_sendResponse(ERROR_ALREADY_IN_CHANNEL(client->get_nickname(), channel->get_name()), fd);
 		return ;
 	}
 
 	// Check user channel limit
-	int count = 0;
-	for (size_t i = 0; i < _channels.size(); i++)
-	{
-		if (this->_channels[i].get_clientByname(client->get_nickname()))
-			count++;
-	}
-	if (count > 10)
+	if (client->get_joinedChannels().size() > 10)
 	{
 		_sendResponse(ERROR_IN_TOO_MANY_CHANNELS(client->get_nickname()), fd);
 		return ;
 	}
 
 	// Check channel modes
-	if (!channel->get_password().empty() && channel->get_password() != key)
+	if (channel->hasMode(CHANMODE_KEY) && channel->get_password() != key)
 	{
 		_sendResponse(ERROR_WRONG_KEY(client->get_nickname(), name), fd);
 		return ;
 	}
 	// 1. Channel is invite-only
-	if (channel->get_ModeAtIndex(0)) // Check 'i' mode at index 0
+	if (channel->hasMode(CHANMODE_INVITE_ONLY))
 	{
 		if (!client->get_channelInvitation(name))
 		{
@@ -118,7 +90,7 @@ void	Server::Channel_Exist(Channel *channel, Client *client, int fd, std::string
 		client->removeChannelInvitation(name);
 	}
 	// 2. Channel has user limit
-	if (channel->get_ModeAtIndex(4)) // Check 'l' mode at index 4
+	if (channel->hasMode(CHANMODE_LIMIT))
 	{
 		if (channel->get_totalUsers() >= channel->get_userLimit())
 		{
@@ -128,18 +100,23 @@ void	Server::Channel_Exist(Channel *channel, Client *client, int fd, std::string
 	}
 
 	// Add user to channel
-	channel->add_client(*client);
+	channel->add_member(*client, 0);
 
 	// 1. JOIN message to ALL (including joiner)
-	channel->broadcast_message(MSG_USER_JOIN(client->get_hostname(), client->get_IPaddress(), name));
+	ReplyBuilder join;
+	replyUserJoin(join, client->get_hostname(), client->get_IPaddress(), name);
+	channel->broadcast_message(join);
 
 	// 2. Names list to joiner only
-	_sendResponse(MSG_NAMES_LIST(client->get_nickname(), name, channel->get_memberList()), fd);
-	_sendResponse(MSG_NAMES_END(client->get_nickname(), name), fd);
+	sendNames(channel, name, client, fd);
 
 	// 3. Topic to joiner only (if exists)
 	if (!channel->get_topicName().empty())
-		_sendResponse(MSG_CHANNEL_TOPIC(client->get_nickname(), name, channel->get_topicName()), fd);
+	{
+		ReplyBuilder topic;
+		replyChannelTopic(topic, client->get_nickname(), name, channel->get_topicName());
+		sendReply(topic, fd);
+	}
 }
 
 /**
@@ -151,11 +128,9 @@ void	Server::Channel_Exist(Channel *channel, Client *client, int fd, std::string
  *
  * @details Handles the creation of a new channel when a client attempts to join
  * a channel that doesn't exist on the server:
- * - Creates a new Channel object with the specified name
- * - Sets the server reference for the new channel
- * - Records the channel creation timestamp
+ * - Creates the channel in the server's channel directory through addChannel(),
+ *   which sets its server reference and creation timestamp
  * - Automatically makes the creating client a channel administrator/operator
- * - Adds the new channel to the server's channel list
  * - Broadcasts JOIN message to notify the client
  * - Sends names list showing the client as the only member
  * - Sends topic information if a topic exists (typically empty for new channels)
@@ -165,37 +140,61 @@ void	Server::Channel_Exist(Channel *channel, Client *client, int fd, std::string
  */
 void	Server::Channel_Not_Exist(std::string channel_name, Client *client, int fd)
 {
-
-	Channel new_channel;
-	new_channel.set_server(this);
-	new_channel.set_name(channel_name);
-	new_channel.set_channelCreationTime();
-
-	new_channel.add_admin(*client);
-	addChannel(new_channel);
-
-	Channel *channel = get_channelByName(channel_name);
+	Channel *channel = addChannel(channel_name);
+	channel->add_member(*client, MEMBER_OP);
 
 	// 1. JOIN message to ALL (including joiner)
-	channel->broadcast_message(MSG_USER_JOIN(client->get_hostname(), client->get_IPaddress(), channel_name));
+	ReplyBuilder join;
+	replyUserJoin(join, client->get_hostname(), client->get_IPaddress(), channel_name);
+	channel->broadcast_message(join);
 
 	// 2. Names list to joiner only
-	_sendResponse(MSG_NAMES_LIST(client->get_nickname(), channel_name, channel->get_memberList()), fd);
-	_sendResponse(MSG_NAMES_END(client->get_nickname(), channel_name), fd);
+	sendNames(channel, channel_name, client, fd);
 
 	// 3. Topic to joiner only (if exists)
 	if (!channel->get_topicName().empty())
-		_sendResponse(MSG_CHANNEL_TOPIC(client->get_nickname(), channel_name, channel->get_topicName()), fd);
+	{
+		ReplyBuilder topic;
+		replyChannelTopic(topic, client->get_nickname(), channel_name, channel->get_topicName());
+		sendReply(topic, fd);
+	}
+}
+
+/**
+ * @brief Sends the member list of a channel to a client: RPL_NAMREPLY (353) lines, then RPL_ENDOFNAMES (366).
+ * @param channel The channel
+ * @param name The channel name as the client wrote it, echoed in the replies like in its JOIN
+ * @param client The requesting client
+ * @param fd File descriptor of the client
+ * @return void
+ *
+ * @details The list is split over as many 353 lines as needed to keep each one within
+ * IRC_LINE_MAX. The payloads come from the channel's cache, see Channel::get_names().
+ */
+void	Server::sendNames(Channel *channel, const std::string &name, Client *client, int fd)
+{
+	std::string nickname = client->get_nickname();
+	const std::vector<std::string> &names = channel->get_names(nickname.size());
+
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		ReplyBuilder line;
+		replyNamesList(line, nickname, name, names[i]);
+		sendReply(line, fd);
+	}
+	ReplyBuilder end;
+	replyNamesEnd(end, nickname, name);
+	sendReply(end, fd);
 }
 
 /**
  * @brief Handles the IRC JOIN command for joining one or more channels.
- * @param cmd The complete JOIN command string received from the client
+ * @param msg The parsed JOIN message received from the client
  * @param fd File descriptor of the client who sent the command
  * @return void
  *
  * @details Processes the IRC JOIN command which allows clients to join channels:
- * - Verifies the client is registered and authenticated on the server
+ * - Is only dispatched to registered clients (CMD_NEEDS_REGISTRATION in the command table)
  * - Retrieves the client object associated with the file descriptor
  * - Parses command parameters to extract channel names and optional keys
  * - Validates parameter count (minimum 1, maximum 10 channels per command)
@@ -208,22 +207,15 @@ void	Server::Channel_Not_Exist(std::string channel_name, Client *client, int fd)
  * @note Supports joining multiple channels in a single command with comma separation
  * @see RFC 2812 Section 3.2.1 for complete JOIN command specifications
  */
-void	Server::JOIN(std::string cmd, int fd)
+void	Server::JOIN(const Message &msg, int fd)
 {
-	//1. Check if user is registered
-	if (!isregistered(fd))
-	{
-		_sendResponse(ERROR_NOT_REGISTERED_YET(std::string("*")), fd);
-		return ;
-	}
-
-	//2. Get client object
+	//1. Get client object
 	Client *client = get_client(fd);
 	if (!client)
 		return ;
 
-	//3. Parse and validate parameters
-	std::vector<std::pair<std::string, std::string> > token = SplitJOIN(cmd);
+	//2. Parse and validate parameters
+	ArenaStringPairList token = SplitJOIN(msg);
 	if (token.size() == 0)
 	{
 		_sendResponse(ERROR_INSUFFICIENT_PARAMS(client->get_nickname()), fd);
@@ -240,17 +232,17 @@ void	Server::JOIN(std::string cmd, int fd)
 		{
 			if (token[i].first.empty() || token[i].first[0] != '#')
 			{
-				_sendResponse(ERROR_CHANNEL_NOT_EXISTS(client->get_nickname(), token[i].first), fd);
+				_sendResponse(ERROR_CHANNEL_NOT_EXISTS(client->get_nickname(), std::string(token[i].first.data(), token[i].first.size())), fd);
 				return ;
 			}
 		}
 	}
 
-	//4. Chanel Existence Logic
+	//3. Chanel Existence Logic
 	for (size_t i = 0; i < token.size(); i++)
 	{
-		std::string channel_name = token[i].first; // "#general"
-		std::string channel_key = token[i].second; // "password" or ""
+		std::string channel_name(token[i].first.data(), token[i].first.size()); // "#general"
+		std::string channel_key(token[i].second.data(), token[i].second.size()); // "password" or ""
 
 		Channel *channel = get_channelByName(channel_name);
 		if (channel)
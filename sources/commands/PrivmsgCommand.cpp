@@ -1,63 +1,51 @@
 #include "../../includes/core/Server.hpp"
 
 /**
- * @brief Parses PRIVMSG command parameters to extract targets and message.
- * @param cmd The complete PRIVMSG command string received from the client
- * @return std::vector<std::string> Vector containing targets and message (message is last element)
+ * @brief Extracts targets and message from the parsed PRIVMSG parameters.
+ * @param msg The parsed PRIVMSG message received from the client
+ * @return ArenaStringList Targets and message (message is last element), held by the reactor's arena
  *
  * @details Parses the PRIVMSG command syntax which supports multiple targets:
- * - Locates the message content after the ':' delimiter
- * - Extracts target list before the ':' character
+ * - The first parameter is the target list, the second one the message content
  * - Handles comma-separated target lists (e.g., "alice,bob,#general")
  * - Splits individual targets and adds them to the result vector
  * - Appends the message content as the last element of the vector
  * - Example: "PRIVMSG alice,#general :Hello everyone" returns ["alice", "#general", "Hello everyone"]
- * - Returns empty vector if invalid format or no message found
+ * - Returns empty vector if the target list or the message is missing
  *
  * @note The message content is always the last element in the returned vector
  * @note Empty targets are automatically filtered out during parsing
  * @see RFC 2812 Section 3.3.1 for PRIVMSG command syntax specifications
  */
-std::vector<std::string> Server::SplitPM(std::string cmd)
+ArenaStringList Server::SplitPM(const Message &msg)
 {
-	// Parse message (everything after ':')
-	std::vector<std::string> result;
-	size_t colon_pos = cmd.find(':');
-	if (colon_pos == std::string::npos)
-		return (result); // No message found
+	ArenaStringList result = ArenaStringList(ArenaAllocator<ArenaString>(get_arena()));
+	if (msg.paramCount() < 2)
+		return (result); // No target or no message
 
-	// Extract target before ':' and split by spaces
-	std::string before_colon = cmd.substr(0, colon_pos);
-	std::vector<std::string> args = split_cmd(before_colon);
-	if (args.size() < 2)
-		return (result); // invalid format
-
-	// Split targets by comma (args[1] = "alice,bob,#general")
-	std::string targets_part = args[1];
-	std::istringstream target_stream(targets_part);
-	std::string single_target;
-
-	while (std::getline(target_stream, single_target, ','))
+	// Split targets by comma (param 0 = "alice,bob,#general")
+	ArenaStringList targets = msg.paramList(0, get_arena());
+	result.reserve(targets.size() + 1);
+	for (size_t i = 0; i < targets.size(); i++)
 	{
-		if (!single_target.empty()) // Skip empty targets
-			result.push_back(single_target); // [target1, target2, target3]
+		if (!targets[i].empty()) // Skip empty targets
+			result.push_back(targets[i]); // [target1, target2, target3]
 	}
 
 	// Add message at the end of the array
-	std::string message = cmd.substr(colon_pos + 1);
-	result.push_back(message); // [target1, target2, target3, message]
+	result.push_back(msg.param(1, get_arena())); // [target1, target2, target3, message]
 
 	return (result);
 }
 
 /**
  * @brief Handles the IRC PRIVMSG command for sending messages to users or channels.
- * @param cmd The complete PRIVMSG command string received from the client
+ * @param msg The parsed PRIVMSG message received from the client
  * @param fd File descriptor of the client who sent the command
  * @return void
  *
  * @details Processes the IRC PRIVMSG command which allows clients to send messages:
- * - Verifies the client is registered and authenticated on the server
+ * - Is only dispatched to registered clients (CMD_NEEDS_REGISTRATION in the command table)
  * - Retrieves the client object associated with the file descriptor
  * - Parses command parameters using SplitPM() to extract targets and message
  * - Validates command format (minimum 1 target + 1 message required)
@@ -69,7 +57,7 @@ std::vector<std::string> Server::SplitPM(std::string cmd)
  * - For each target, determines if it's a channel (starts with '#') or user:
  *   - **Channel messages**: Validates channel existence and sender membership,
  *     then broadcasts to all channel members except the sender
- *   - **User messages**: Validates target user existence, then sends direct message
+ *   - **User messages**: Looks the target up in the nick registry (case insensitive), then sends direct message
  * - Continues processing remaining targets even if some fail validation
  * - Sends appropriate error responses for invalid targets or conditions
  *
@@ -78,34 +66,26 @@ std::vector<std::string> Server::SplitPM(std::string cmd)
  * @note Messages are broadcast to all channel members except the sender
  * @see RFC 2812 Section 3.3.1 for complete PRIVMSG command specifications
  */
-void Server::PRIVMSG(std::string cmd, int fd)
+void Server::PRIVMSG(const Message &msg, int fd)
 {
-	//1. Check if user is registered
-	if (!isregistered(fd))
-	{
-		_sendResponse(ERROR_NOT_REGISTERED_YET(std::string("*")), fd);
-		return ;
-	}
-
 	Client *client = get_client(fd);
 	if (!client)
 		return ;
-	std::string client_nick = client->get_nickname();
+	const std::string &client_nick = client->get_nickname();
 
 	// 2. Parse parameters and checks
-	std::vector<std::string> token = SplitPM(cmd);
+	ArenaStringList token = SplitPM(msg);
 	if (token.size() < 2)  // At least 1 target + 1 message
 	{
 		_sendResponse(ERROR_INSUFFICIENT_PARAMS(client_nick), fd);
 		return ;
 	}
 
-	// Extract message (last element) and targets (all others)
-	std::string message = token.back();
-	token.pop_back(); // Remove message, leaving only targets
-	std::vector<std::string> targets = token;
+	// Message is the last element, targets are all the others (referenced in place, nothing is copied)
+	const ArenaString &message = token.back();
+	size_t targetCount = token.size() - 1;
 
-	if (targets.empty())
+	if (targetCount == 0)
 	{
 		_sendResponse(ERROR_NO_RECIPIENT(client_nick), fd);
 		return ;
@@ -115,16 +95,16 @@ void Server::PRIVMSG(std::string cmd, int fd)
 		_sendResponse(ERROR_NO_TEXT_TO_SEND(client_nick), fd);
 		return ;
 	}
-	if (targets.size() > 10)
+	if (targetCount > 10)
 	{
 		_sendResponse(ERROR_TOO_MANY_TARGETS(client_nick), fd);
 		return ;
 	}
 
 	// 4. Process each target
-	for (size_t i = 0; i < targets.size(); i++)
+	for (size_t i = 0; i < targetCount; i++)
 	{
-		std::string target = targets[i];
+		std::string target(token[i].data(), token[i].size());
 
 		if (target[0] == '#') // Channel
 		{
@@ -135,23 +115,28 @@ void Server::PRIVMSG(std::string cmd, int fd)
 				_sendResponse(ERROR_CHANNEL_NOT_EXISTS(client_nick, target), fd);
 				continue ; // Continue to next target
 			}
-			else if (!channel->get_clientByFd(fd) && !channel->get_adminByFd(fd))
+			else if (!channel->isMember(fd))
 			{
 				_sendResponse(ERROR_NOT_IN_CHANNEL(client_nick, channel->get_name()), fd);
 				continue ; // Continue to next target
 			}
 			// Send to channel
-			channel->broadcast_messageExcept(MSG_PRIVMSG_CHANNEL(client_nick, client->get_username(), target, message), fd);
+			ReplyBuilder reply;
+			replyPrivmsgChannel(reply, client->get_source(), target, message);
+			channel->broadcast_messageExcept(reply, fd);
 		}
 		else // User
 		{
-			if (!get_clientNick(target))
+			Client *recipient = get_clientNick(target);
+			if (!recipient)
 			{
 				_sendResponse(ERROR_NICK_NOT_FOUND(target, client_nick), fd);
 				continue ; // Continue to next target
 			}
 			// Send to user
-			_sendResponse(MSG_PRIVMSG_USER(client->get_nickname(), client->get_username(), target, message), get_clientNick(target)->get_fd());
+			ReplyBuilder reply;
+			replyPrivmsgUser(reply, client_nick, client->get_username(), target, message);
+			sendReply(reply, recipient->get_fd());
 		}
 	}
 }
@@ -1,15 +1,14 @@
 #include "../../includes/core/Server.hpp"
 
 /**
- * @brief Parses QUIT command parameters to extract the quit reason message.
- * @param cmd The complete QUIT command string received from the client
+ * @brief Builds the quit reason message from the parsed QUIT parameters.
+ * @param msg The parsed QUIT message received from the client
  * @return std::string The quit reason message or "Leaving" as default
  *
  * @details Parses the QUIT command syntax to extract the optional quit reason:
- * - Splits the command by spaces to separate arguments
- * - Concatenates all arguments after "QUIT" to form the reason message
+ * - Concatenates all parameters to form the reason message
  * - Handles space preservation between multiple words in the reason
- * - Removes leading ':' character if present (IRC protocol syntax)
+ * - The leading ':' of a trailing parameter is already stripped by Message::parse()
  * - Provides default reason "Leaving" if no custom reason is specified
  * - Examples:
  *   - "QUIT" returns "Leaving" (default)
@@ -20,22 +19,16 @@
  * @note Multiple words are properly concatenated with spaces preserved
  * @see RFC 2812 Section 3.1.7 for QUIT command syntax specifications
  */
-std::string	Server::SplitQUIT(std::string cmd)
+std::string	Server::SplitQUIT(const Message &msg)
 {
-	// Split by spaces
-	std::vector<std::string> args = split_cmd(cmd);
 	std::string result;
-	for (size_t i = 1; i < args.size(); i++)
+	for (size_t i = 0; i < msg.paramCount(); i++)
 	{
 		if (!result.empty())
 			result += " ";
-		result += args[i];
+		result.append(msg.paramData(i), msg.paramLength(i));
 	}
 
-	// Remove leading ':' if present
-	if (!result.empty() && result[0] == ':')
-		result.erase(0, 1);
-
 	// Default reason if empty
 	if (result.empty())
 		result = "Leaving";
@@ -45,7 +38,7 @@ std::string	Server::SplitQUIT(std::string cmd)
 
 /**
  * @brief Handles the IRC QUIT command for client disconnection from the server.
- * @param cmd The complete QUIT command string received from the client
+ * @param msg The parsed QUIT message received from the client
  * @param fd File descriptor of the client who sent the command
  * @return void
  *
@@ -73,12 +66,12 @@ std::string	Server::SplitQUIT(std::string cmd)
  * @warning Index adjustment (i--) is critical during channel removal to prevent skipping
  * @see RFC 2812 Section 3.1.7 for complete QUIT command specifications
  */
-void	Server::QUIT(std::string cmd, int fd)
+void	Server::QUIT(const Message &msg, int fd)
 {
 	//1. Check if user is registered
 	if (!isregistered(fd))
 	{
-		get_client(fd)->set_isQuitting(true); //new
+		scheduleClose(get_client(fd));
 		return ;
 	}
 
@@ -86,28 +79,19 @@ void	Server::QUIT(std::string cmd, int fd)
 	Client *client = get_client(fd);
 	if (!client)
 		return ;
-	std::string client_nick = client->get_nickname();
 
 	//3. Parse parameters
-	std::string reason = SplitQUIT(cmd);
+	std::string reason = SplitQUIT(msg);
 
 	//4. Broadcast message to channel(s)
-	std::set<int> notified_fds; //new
-	for (size_t i = 0; i < _channels.size(); i++)
-	{
-		if (_channels[i].get_clientByname(client_nick))
-			_channels[i].broadcast_message(MSG_QUIT(client_nick, client->get_username(), reason), notified_fds);
-	}
+	unsigned long epoch = beginFanout(); //members of several of the channels hear it once
+	ReplyBuilder reply;
+	replyQuit(reply, client->get_source(), reason);
+	SharedBuffer quit = formatReply(reply); //serialized once, whatever the number of channels
+	const std::vector<Channel*> &joined = client->get_joinedChannels();
+	for (size_t i = 0; i < joined.size(); i++)
+		joined[i]->broadcast_message(quit, epoch);
 
-	//5. Remove client and close empty channel(s)
+	//5. Remove client, ft_close() also removes the channel(s) it leaves empty
 	ft_close(fd);
-	for (size_t i = 0; i < _channels.size(); i++)
-	{
-		if (_channels[i].get_totalUsers() == 0)
-		{
-			std::string channel_name = _channels[i].get_name();
-			RemoveChannel(channel_name);
-			i--; // avoids skipping since every channel is shigting back one possition when a channel is removed
-		}
-	}
 }
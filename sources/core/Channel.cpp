@@ -3,16 +3,11 @@
 Channel::Channel()
 {
 	this->_server = NULL;
-	this->_inviteOnly = 0;
-	this->_topic = 0;
-	this->_key = 0;
+	this->_modes = 0;
 	this->_limit = 0;
-	this->_topicRestriction = false;
 	this->_name = "";
 	this->_topicName = "";
-	char characters[] = {'i', 't', 'k', 'o', 'l'};
-	for(size_t i = 0; i < sizeof(characters)/sizeof(characters[0]); i++)
-		_modes.push_back(std::make_pair(characters[i], false));
+	this->_namesValid = false;
 	this->_createdAt = "";
 }
 Channel::~Channel(){}
@@ -21,18 +16,17 @@ Channel &Channel::operator=(Channel const &src){
 	if (this != &src)
 	{
 		this->_server = src._server;
-		this->_inviteOnly = src._inviteOnly;
-		this->_topic = src._topic;
-		this->_key = src._key;
+		this->_modes = src._modes;
+		this->_activeModes = src._activeModes;
 		this->_limit = src._limit;
-		this->_topicRestriction = src._topicRestriction;
 		this->_name = src._name;
 		this->_password = src._password;
 		this->_createdAt = src._createdAt;
 		this->_topicName = src._topicName;
-		this->_clients = src._clients;
-		this->_admins = src._admins;
-		this->_modes = src._modes;
+		this->_members = src._members;
+		this->_recipients = src._recipients;
+		this->_names = src._names;
+		this->_namesValid = src._namesValid;
 	}
 	return *this;
 }
@@ -41,30 +35,44 @@ Channel &Channel::operator=(Channel const &src){
 /*    Setters    */
 /*****************/
 void Channel::set_server(Server *server){this->_server = server;}
-void Channel::set_inviteOnly(int invitation){this->_inviteOnly = invitation;}
-void Channel::set_topicMode(int topic){this->_topic = topic;}
 void Channel::set_topicModificationTime(std::string time){this->_timeCreation = time;}
-void Channel::set_keyMode(int key){this->_key = key;}
 void Channel::set_userLimit(int limit){this->_limit = limit;}
 void Channel::set_topicName(std::string topic_name){this->_topicName = topic_name;}
 void Channel::set_topicCreator(std::string creator){this->_topicCreator = creator;}
 void Channel::set_password(std::string password){this->_password = password;}
-void Channel::set_name(std::string name){this->_name = name;}
-void Channel::set_topicRestriction(bool value){this->_topicRestriction = value;}
-void Channel::set_modeAtIndex(size_t index, bool mode){_modes[index].second = mode;}
+void Channel::set_name(std::string name){this->_name = name; this->_namesValid = false;}
 void Channel::set_channelCreationTime(){this->_createdAt = Server::getCurrentTime();}
 
+/**
+ * @brief Sets or clears channel mode bits and rebuilds the cached mode string.
+ * @param mode ChannelMode bits to change
+ * @param value True to set them, false to clear them
+ * @return void
+ * @note The letters are listed in the order of _modeTable, so "+itkl" stays stable
+ */
+void Channel::set_mode(unsigned int mode, bool value)
+{
+	if (value)
+		this->_modes |= mode;
+	else
+		this->_modes &= ~mode;
+	this->_activeModes.clear();
+	for (size_t i = 0; i < CHANNEL_MODE_COUNT; i++)
+	{
+		if (_modeTable[i].kind != MODEKIND_MEMBER && (this->_modes & _modeTable[i].bit))
+			this->_activeModes.push_back(_modeTable[i].letter);
+	}
+	if (!this->_activeModes.empty())
+		this->_activeModes.insert(this->_activeModes.begin(), '+');
+}
+
 /*****************/
 /*    Getters    */
 /*****************/
-int Channel::get_invitOnly(){return this->_inviteOnly;}
-int Channel::get_topicMode(){return this->_topic;}
-int Channel::get_keyMode(){return this->_key;}
+bool Channel::hasMode(unsigned int mode) const{return (this->_modes & mode) != 0;}
 int Channel::get_userLimit(){return this->_limit;}
-int Channel::get_totalUsers(){return this->_clients.size() + this->_admins.size();}
-bool Channel::get_topicRestriction() const{return this->_topicRestriction;}
-bool Channel::get_ModeAtIndex(size_t index){return _modes[index].second;}
-bool Channel::isClientInChannel(std::string &nick){return get_clientByname(nick) != NULL;}
+int Channel::get_totalUsers(){return this->_members.size();}
+bool Channel::isMember(int fd){return get_member(fd) != NULL;}
 std::string Channel::get_topicName(){return this->_topicName;}
 std::string Channel::get_topicCreator() const {return this->_topicCreator;}
 std::string Channel::get_password(){return this->_password;}
@@ -74,224 +82,292 @@ std::string Channel::get_channelCreationTime(){return _createdAt;}
 
 /**
  * @brief Gets active channel modes formatted as a mode string.
- * @return std::string Formatted mode string (e.g., "+itk") or empty string if no modes
- * @note Excludes 'o' (operator) mode from the result as it's handled separately
+ * @return const std::string& Formatted mode string (e.g., "+itk") or empty string if no modes
+ * @note Kept up to date by set_mode(), reading it builds nothing.
+ * Member modes ('o', 'v') are not channel state and are never listed.
  */
-std::string Channel::get_activeModes()
+const std::string &Channel::get_activeModes() const{return this->_activeModes;}
+
+/**
+ * @brief Gets the member list as the payloads of RPL_NAMREPLY (353) lines.
+ * @param nickLength Length of the requester's nickname, which is part of every 353 line
+ * @return const std::vector<std::string>& Space-separated lists of "@nick", "+nick" or "nick",
+ * each short enough for its 353 line to stay within IRC_LINE_MAX
+ *
+ * @details The payloads are cached. A join appends its entry to the last one (see add_member()),
+ * so the common JOIN path formats one nickname instead of the whole channel.
+ * A part, a nick change or a status change marks the cache stale; it is rebuilt here on the next call.
+ * @note A requester whose nickname is longer than NAMES_NICK_RESERVE gets uncached payloads
+ */
+const std::vector<std::string> &Channel::get_names(size_t nickLength)
 {
-	std::string result;
-	for(size_t i = 0; i < _modes.size(); i++)
+	if (nickLength > NAMES_NICK_RESERVE)
+	{
+		buildNames(_namesScratch, namesBudget(nickLength));
+		return _namesScratch;
+	}
+	if (!_namesValid)
 	{
-		if(_modes[i].first != 'o' && _modes[i].second)
-			result.push_back(_modes[i].first);
+		buildNames(_names, namesBudget(NAMES_NICK_RESERVE));
+		_namesValid = true;
 	}
-	if(!result.empty())
-		result.insert(result.begin(),'+');
-	return (result);
+	return _names;
 }
 
 /**
- * @brief Gets formatted list of channel members with operator prefixes.
- * @return std::string Space-separated list with "@" prefix for operators
+ * @brief Bytes left for the member list in a 353 line, once the rest of MSG_NAMES_LIST is written.
+ * @param nickLength Length of the requester's nickname
  */
-std::string Channel::get_memberList()
+size_t Channel::namesBudget(size_t nickLength)
 {
-	std::ostringstream oss;
+	size_t overhead = sizeof(":ft_irc 353 ") - 1 + nickLength + sizeof(" @ ") - 1 + _name.size() + sizeof(" :") - 1 + sizeof(CRLF) - 1;
+	if (overhead >= IRC_LINE_MAX)
+		return 1; //one entry per line, the best a very long channel name allows
+	return IRC_LINE_MAX - overhead;
+}
 
-	// Add admins with @ prefix
-	for (size_t i = 0; i < _admins.size(); i++)
-	{
-		if (i > 0)
-			oss << " "; // Add space before (except first)
-		oss << "@" << _admins[i].get_nickname(); // Add @username
-	}
+/**
+ * @brief Formats the NAMES entry of a member: its nickname with "@" for operators and "+" for voiced members.
+ * @param index Position of the member in _members
+ * @return std::string The entry, empty if the client is gone
+ * @note Nicknames are read from the clients themselves, so they are never stale after a NICK
+ */
+std::string Channel::namesEntry(size_t index)
+{
+	Client *client = _server->get_clientByHandle(_members[index].handle);
+	if (!client)
+		return "";
+	if (_members[index].flags & MEMBER_OP)
+		return "@" + client->get_nickname();
+	if (_members[index].flags & MEMBER_VOICE)
+		return "+" + client->get_nickname();
+	return client->get_nickname();
+}
 
-	// Add regular clients
-	for(size_t i = 0; i < _clients.size(); i++)
-	{
-		if(i > 0 || !_admins.empty()) // Add space before each client (except first client)
-			oss << " ";
-		oss << _clients[i].get_nickname();
-	}
+/**
+ * @brief Appends a NAMES entry to the last payload, or starts a new one when it would not fit.
+ */
+static void appendNamesEntry(std::vector<std::string> &chunks, const std::string &entry, size_t budget)
+{
+	if (entry.empty())
+		return;
+	if (!chunks.empty() && chunks.back().size() + 1 + entry.size() <= budget)
+		chunks.back().append(" ").append(entry);
+	else
+		chunks.push_back(entry); //an entry longer than the budget still gets a line of its own
+}
 
-	return oss.str();
+/**
+ * @brief Formats every member into 353 payloads of at most budget bytes.
+ */
+void Channel::buildNames(std::vector<std::string> &chunks, size_t budget)
+{
+	chunks.clear();
+	for (size_t i = 0; i < _members.size(); i++)
+		appendNamesEntry(chunks, namesEntry(i), budget);
 }
 
-Client *Channel::get_clientByFd(int fd)
+/**
+ * @brief Marks the cached 353 payloads stale, e.g. after a member changed its nickname.
+ */
+void Channel::invalidateNames()
 {
-	for (std::vector<Client>::iterator it = _clients.begin(); it != _clients.end(); ++it)
-	{
-		if (it->get_fd() == fd)
-			return &(*it);
-	}
-	return NULL;
+	_namesValid = false;
 }
 
-Client *Channel::get_adminByFd(int fd)
+/**
+ * @brief Finds the membership of a client.
+ * @param fd File descriptor of the client
+ * @return Member* The membership, or NULL if the client is not in the channel
+ */
+Member *Channel::get_member(int fd)
 {
-	for (std::vector<Client>::iterator it = _admins.begin(); it != _admins.end(); ++it){
-		if (it->get_fd() == fd)
-			return &(*it);
-	}
-	return NULL;
+	std::vector<int>::iterator it = std::find(_recipients.begin(), _recipients.end(), fd);
+	if (it == _recipients.end())
+		return NULL;
+	return &_members[it - _recipients.begin()];
 }
 
 /**
- * @brief Finds client by nickname in both regular members and operators.
- * @param name Nickname to search for
- * @return Client* Pointer to client if found, NULL otherwise
+ * @brief Tells whether a client is a channel operator.
  */
-Client* Channel::get_clientByname(std::string name)
+bool Channel::isOperator(int fd)
 {
-	for (std::vector<Client>::iterator it = _clients.begin(); it != _clients.end(); ++it)
-	{
-		if (it->get_nickname() == name)
-			return &(*it);
-	}
-	for (std::vector<Client>::iterator it = _admins.begin(); it != _admins.end(); ++it)
-	{
-		if (it->get_nickname() == name)
-			return &(*it);
-	}
-	return NULL;
+	Member *member = get_member(fd);
+	return member && (member->flags & MEMBER_OP);
+}
+
+/**
+ * @brief Tells whether a member holds the status a mode change asks for.
+ * @param fd File descriptor of the member
+ * @param privilege MemberFlag bits it needs any of (ModeSpec::privilege), 0 for none
+ * @return bool True if fd is a member with one of the bits, or privilege is 0 and fd is a member
+ */
+bool Channel::hasPrivilege(int fd, unsigned int privilege)
+{
+	Member *member = get_member(fd);
+	return member && (!privilege || (member->flags & privilege));
 }
 
 
 /*****************/
 /*    Methods    */
 /*****************/
-void Channel::add_client(Client newClient){_clients.push_back(newClient);}
-void Channel::add_admin(Client newClient){_admins.push_back(newClient);}
-void Channel::remove_client(int fd)
+/**
+ * @brief Adds a client to the channel, referencing it by handle.
+ * @param client The joining client, which also lists the channel in its joined channels
+ * @param flags Initial MemberFlag bits (MEMBER_OP for the creator of the channel)
+ * @return void
+ */
+void Channel::add_member(Client &client, unsigned int flags)
 {
-	for (std::vector<Client>::iterator it = _clients.begin(); it != _clients.end(); ++it)
-	{
-		if (it->get_fd() == fd)
-		{
-			_clients.erase(it);
-			break;
-		}
-	}
+	Member member;
+	member.handle = client.get_handle();
+	member.flags = flags;
+	_members.push_back(member);
+	_recipients.push_back(client.get_fd());
+	if (_namesValid)
+		appendNamesEntry(_names, namesEntry(_members.size() - 1), namesBudget(NAMES_NICK_RESERVE));
+	client.addJoinedChannel(this);
 }
 
-void Channel::remove_admin(int fd)
+/**
+ * @brief Removes a client from the channel, whatever its status.
+ * @param fd File descriptor of the client
+ * @return void
+ * @note Also drops the channel from the client's joined channels
+ */
+void Channel::remove_member(int fd)
 {
-	for (std::vector<Client>::iterator it = _admins.begin(); it != _admins.end(); ++it)
-	{
-		if (it->get_fd() == fd)
-		{
-			_admins.erase(it);
-			break;
-		}
-	}
+	std::vector<int>::iterator it = std::find(_recipients.begin(), _recipients.end(), fd);
+	if (it == _recipients.end())
+		return;
+	size_t index = it - _recipients.begin();
+	Client *client = _server->get_clientByHandle(_members[index].handle);
+	if (client)
+		client->removeJoinedChannel(this);
+	_members.erase(_members.begin() + index);
+	_recipients.erase(it);
+	_namesValid = false;
 }
 
 /**
- * @brief Moves a client between two vectors (e.g., member to operator).
- * @param from Source vector to remove client from
- * @param to Destination vector to add client to
- * @param nick Nickname of client to move
- * @return bool True if client was found and moved, false otherwise
+ * @brief Sets or clears a status bit of a member (e.g. MEMBER_OP for +o/-o).
+ * @param fd File descriptor of the member
+ * @param flag The MemberFlag bit
+ * @param value True to set it, false to clear it
+ * @return bool True if the client is a member and its status changed, false otherwise
  */
-bool Channel::moveClientBetween(std::vector<Client> &from,
-	std::vector<Client> &to, const std::string &nick)
+bool Channel::set_memberFlag(int fd, unsigned int flag, bool value)
 {
-	for(std::vector<Client>::iterator it = from.begin(); it != from.end(); ++it)
-	{
-		if(it->get_nickname() == nick)
-		{
-			to.push_back(*it); // Copy to destination
-			from.erase(it); // Remove from source
-			return (true);
-		}
-	}
-	return (false);
+	Member *member = get_member(fd);
+	if (!member || ((member->flags & flag) != 0) == value)
+		return (false);
+	if (value)
+		member->flags |= flag;
+	else
+		member->flags &= ~flag;
+	_namesValid = false;
+	return (true);
 }
 
 /**
- * @brief Promotes a regular member to operator status.
+ * @brief Sends message to all channel members (operators and regular members).
+ * @note The reply is serialized once and the same buffer is queued for every member.
  */
-bool Channel::change_clientToAdmin(std::string& nick)
-	{return moveClientBetween(_clients, _admins, nick);}
+void Channel::broadcast_message(const std::string &reply)
+{
+	fanout(_server->formatReply(reply));
+}
+
+void Channel::broadcast_message(const ReplyBuilder &reply)
+{
+	fanout(_server->formatReply(reply));
+}
 
 /**
- * @brief Demotes an operator to regular member status.
+ * @brief Sends a reply to the channel members not already reached by the same multi-channel broadcast.
+ * @param buffer The reply, serialized once by the caller for all the channels of the broadcast
+ * @param epoch The broadcast, as returned by Server::beginFanout()
+ * @note Members reached here are stamped with the epoch, the next channel of the broadcast skips them.
  */
-bool Channel::change_adminToClient(std::string& nick)
-	{return moveClientBetween(_admins, _clients, nick);}
+void Channel::broadcast_message(const SharedBuffer &buffer, unsigned long epoch)
+{
+	fanout(buffer, -1, epoch);
+}
 
 /**
- * @brief Sends message to all channel members (operators and regular members).
+ * @brief Sends message to all channel members except specified file descriptor.
+ * @param fd File descriptor to exclude from broadcast
  */
-void Channel::broadcast_message(std::string reply)
+void Channel::broadcast_messageExcept(const std::string &reply, int fd)
 {
-	for(size_t i = 0; i <_admins.size(); i++)
-		_server->_sendResponse(reply, _admins[i].get_fd());
-
-	for(size_t i = 0; i < _clients.size(); i++)
-		_server->_sendResponse(reply, _clients[i].get_fd());
+	fanoutExcept(_server->formatReply(reply), fd);
 }
 
-void Channel::broadcast_message(std::string reply, std::set<int>& notified_fds)
+void Channel::broadcast_messageExcept(const ReplyBuilder &reply, int fd)
 {
-	for(size_t i = 0; i <_admins.size(); i++)
-	{
-		if(notified_fds.find(_admins[i].get_fd()) == notified_fds.end())
-		{
-			_server->_sendResponse(reply, _admins[i].get_fd());
-			notified_fds.insert(_admins[i].get_fd());
-		}
-	}
-	for(size_t i = 0; i < _clients.size(); i++)
-	{
-		if(notified_fds.find(_clients[i].get_fd()) == notified_fds.end())
-		{
-			_server->_sendResponse(reply, _clients[i].get_fd());
-			notified_fds.insert(_clients[i].get_fd());
-		}
-	}
+	fanoutExcept(_server->formatReply(reply), fd);
 }
 
 /**
- * @brief Sends message to all channel members except specified file descriptor.
+ * @brief Same as broadcast_message(buffer, epoch), without the specified file descriptor.
  * @param fd File descriptor to exclude from broadcast
+ * @param epoch The broadcast, as returned by Server::beginFanout()
  */
-void Channel::broadcast_messageExcept(std::string reply, int fd)
+void Channel::broadcast_messageExcept(const SharedBuffer &buffer, int fd, unsigned long epoch)
 {
-	for(size_t i = 0; i < _admins.size(); i++)
-	{
-		if(_admins[i].get_fd() != fd)
-			_server->_sendResponse(reply, _admins[i].get_fd());
-	}
-	for(size_t i = 0; i < _clients.size(); i++)
-	{
-		if(_clients[i].get_fd() != fd)
-			_server->_sendResponse(reply, _clients[i].get_fd());
-	}
+	fanout(buffer, fd, epoch);
 }
 
-void Channel::broadcast_messageExcept(std::string reply, int fd, std::set<int>& notified_fds)
+/**
+ * @brief Queues an already serialized reply for every member.
+ */
+void Channel::fanout(const SharedBuffer &buffer)
 {
-	for(size_t i = 0; i < _admins.size(); i++)
-	{
-		if(_admins[i].get_fd() != fd)
-		{
-			if(notified_fds.find(_admins[i].get_fd()) == notified_fds.end())
-			{
-				_server->_sendResponse(reply, _admins[i].get_fd());
-				notified_fds.insert(_admins[i].get_fd());
-			}
-		}
-	}
-	for(size_t i = 0; i < _clients.size(); i++)
+	for(size_t i = 0; i < _recipients.size(); i++)
+		_server->sendBuffer(buffer, _recipients[i]);
+
+	_server->recordFanout(buffer, _recipients.size());
+}
+
+/**
+ * @brief Queues an already serialized reply for every member but one.
+ * @param fd File descriptor to skip (not necessarily a member)
+ */
+void Channel::fanoutExcept(const SharedBuffer &buffer, int fd)
+{
+	size_t sender = std::find(_recipients.begin(), _recipients.end(), fd) - _recipients.begin();
+
+	//the sender splits the members in two runs, neither loop tests each fd again
+	for(size_t i = 0; i < sender; i++)
+		_server->sendBuffer(buffer, _recipients[i]);
+	for(size_t i = sender + 1; i < _recipients.size(); i++)
+		_server->sendBuffer(buffer, _recipients[i]);
+
+	_server->recordFanout(buffer, _recipients.size() - (sender < _recipients.size()));
+}
+
+/**
+ * @brief Queues an already serialized reply for the members whose fanout stamp is not yet epoch.
+ * @param fd File descriptor to skip, -1 for none
+ * @param epoch The broadcast, as returned by Server::beginFanout()
+ */
+void Channel::fanout(const SharedBuffer &buffer, int fd, unsigned long epoch)
+{
+	size_t recipients = 0;
+
+	for(size_t i = 0; i < _members.size(); i++)
 	{
-		if(_clients[i].get_fd() != fd)
+		if(_recipients[i] == fd)
+			continue;
+		Client *client = _server->get_clientByHandle(_members[i].handle);
+		if(client && client->get_fanoutStamp() != epoch)
 		{
-			if(notified_fds.find(_clients[i].get_fd()) == notified_fds.end())
-			{
-				_server->_sendResponse(reply, _clients[i].get_fd());
-				notified_fds.insert(_clients[i].get_fd());
-			}
+			client->set_fanoutStamp(epoch);
+			_server->sendBuffer(buffer, _recipients[i]);
+			recipients++;
 		}
 	}
+	_server->recordFanout(buffer, recipients);
 }
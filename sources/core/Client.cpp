@@ -1,4 +1,5 @@
 #include "../../includes/core/Client.hpp"
+#include "../../includes/utils/CaseMapping.hpp"
 
 Client::Client()
 {
@@ -7,20 +8,43 @@ Client::Client()
 		this->_passRegistered = false;
 		this->_logedIn = false;
 		this->_isQuitting = false;
+		this->_sendOffset = 0;
+		this->_sendInFlight = 0;
+		this->_sendQueueBytes = 0;
+		this->_sendQueueHighWater = 0;
+		this->_wantsWrite = false;
+		this->_flushScheduled = false;
+		this->_reactor = 0;
+		this->_readPending = false;
+		this->_fanoutStamp = 0;
+		updatePrefixes();
 }
 
 Client::Client(Client const &copy)
 {
 	this->_fd = copy._fd;
+	this->_handle = copy._handle;
 	this->_IPaddress = copy._IPaddress;
 	this->_nickname = copy._nickname;
 	this->_username = copy._username;
-	this->_buffer = copy._buffer;
+	this->_source = copy._source;
+	this->_hostname = copy._hostname;
+	this->_framer = copy._framer;
+	this->_readPending = copy._readPending;
 	this->_channels = copy._channels;
-	this->_cmd = copy._cmd;
+	this->_joined = copy._joined;
 	this->_logedIn = copy._logedIn;
 	this->_passRegistered = copy._passRegistered;
 	this->_isQuitting = copy._isQuitting;
+	this->_sendQueue = copy._sendQueue;
+	this->_sendOffset = copy._sendOffset;
+	this->_sendInFlight = copy._sendInFlight;
+	this->_sendQueueBytes = copy._sendQueueBytes;
+	this->_sendQueueHighWater = copy._sendQueueHighWater;
+	this->_wantsWrite = copy._wantsWrite;
+	this->_flushScheduled = copy._flushScheduled;
+	this->_reactor = copy._reactor;
+	this->_fanoutStamp = copy._fanoutStamp;
 }
 
 Client& Client::operator=(Client const &copy)
@@ -28,15 +52,28 @@ Client& Client::operator=(Client const &copy)
 	if(this != &copy)
 	{
 		this->_fd = copy._fd;
+		this->_handle = copy._handle;
 		this->_IPaddress = copy._IPaddress;
 		this->_nickname = copy._nickname;
 		this->_username = copy._username;
-		this->_buffer = copy._buffer;
+		this->_source = copy._source;
+		this->_hostname = copy._hostname;
+		this->_framer = copy._framer;
+		this->_readPending = copy._readPending;
 		this->_channels = copy._channels;
-		this->_cmd = copy._cmd;
+		this->_joined = copy._joined;
 		this->_logedIn = copy._logedIn;
 		this->_passRegistered = copy._passRegistered;
 		this->_isQuitting = copy._isQuitting;
+		this->_sendQueue = copy._sendQueue;
+		this->_sendOffset = copy._sendOffset;
+		this->_sendInFlight = copy._sendInFlight;
+		this->_sendQueueBytes = copy._sendQueueBytes;
+		this->_sendQueueHighWater = copy._sendQueueHighWater;
+		this->_wantsWrite = copy._wantsWrite;
+		this->_flushScheduled = copy._flushScheduled;
+		this->_reactor = copy._reactor;
+		this->_fanoutStamp = copy._fanoutStamp;
 	}
 	return(*this);
 }
@@ -47,51 +84,78 @@ Client::~Client(){}
 /*****************/
 /*    Setters    */
 /*****************/
-void Client::set_username(std::string username){_username = username;}
-void Client::set_nickname(std::string nickname){_nickname = nickname;}
+void Client::set_username(std::string username){_username = username; updatePrefixes();}
+void Client::set_nickname(std::string nickname){_nickname = nickname; updatePrefixes();}
 void Client::set_IPaddress(const std::string& address){_IPaddress = address;}
 void Client::set_fd(int fd){_fd = fd;}
-void Client::set_buffer(const std::string& chunk){_buffer += chunk;}
-void Client::set_cmd(const std::vector<std::string>& cmds){_cmd = cmds;}
+void Client::set_handle(ClientHandle handle){_handle = handle;}
 void Client::set_passRegistered(const bool value){_passRegistered = value;}
 void Client::set_logedIn(const bool value){_logedIn = value;}
 void Client::set_isQuitting(const bool value){_isQuitting = value;}
+void Client::set_wantsWrite(const bool value){_wantsWrite = value;}
+void Client::set_flushScheduled(const bool value){_flushScheduled = value;}
+void Client::set_reactor(size_t index){_reactor = index;}
+void Client::set_readPending(const bool value){_readPending = value;}
+void Client::set_sendInFlight(size_t entries){_sendInFlight = entries;}
+void Client::set_fanoutStamp(unsigned long epoch){_fanoutStamp = epoch;}
 
 
 /*****************/
 /*    Getters    */
 /*****************/
-std::string Client::get_username() const {return _username;}
-std::string Client::get_nickname() const {return _nickname;}
+const std::string &Client::get_username() const {return _username;}
+const std::string &Client::get_nickname() const {return _nickname;}
+const std::string &Client::get_source() const {return _source;}
 std::string Client::get_IPaddress() const {return _IPaddress;}
 int Client::get_fd() const {return _fd;}
-const std::string& Client::get_buffer() const {return _buffer;}
-const std::vector<std::string>& Client::get_cmd() const {return _cmd;}
+ClientHandle Client::get_handle() const {return _handle;}
 const std::vector<std::string>& Client::get_channels() const {return _channels;}
+const std::vector<Channel*>& Client::get_joinedChannels() const {return _joined;}
 bool Client::get_logedIn() const {return this->_logedIn;}
 bool Client::get_isQuitting() const {return this->_isQuitting;}
 bool Client::get_passRegistered() const {return this->_passRegistered;}
+size_t Client::get_sendQueueBytes() const {return this->_sendQueueBytes;}
+size_t Client::get_sendQueueHighWater() const {return this->_sendQueueHighWater;}
+bool Client::get_wantsWrite() const {return this->_wantsWrite;}
+bool Client::get_flushScheduled() const {return this->_flushScheduled;}
+size_t Client::get_reactor() const {return this->_reactor;}
+bool Client::get_readPending() const {return this->_readPending;}
+size_t Client::get_sendInFlight() const {return this->_sendInFlight;}
+unsigned long Client::get_fanoutStamp() const {return this->_fanoutStamp;}
+LineFramer &Client::get_framer() {return this->_framer;}
+ClientClass Client::get_class() const {return this->_logedIn ? CLASS_USER : CLASS_UNREGISTERED;}
 
 /**
- * @brief Creates IRC-formatted hostname string.
- * @return std::string Formatted as "nickname!username"
+ * @brief Gets IRC-formatted hostname string.
+ * @return const std::string& Formatted as "nickname!username"
  */
-std::string Client::get_hostname() const
+const std::string &Client::get_hostname() const {return _hostname;}
+
+/**
+ * @brief Rebuilds the prefixes this client's messages start with, after a NICK or USER.
+ * @details Replies splice them as they are (see replyPrivmsgChannel()), instead of
+ * concatenating the nickname and username again for every message.
+ */
+void Client::updatePrefixes()
 {
-	std::string hostname = this->get_nickname() + "!" + this->get_username();
-	return hostname;
+	_hostname.clear();
+	_hostname.append(_nickname).append("!").append(_username);
+	_source.clear();
+	_source.append(_nickname).append("!~").append(_username).append("@localhost");
 }
 
 /**
  * @brief Checks if client has an invitation to a specific channel.
  * @param channel_name Name of channel to check invitation for
  * @return bool True if invitation exists, false otherwise
+ * @note Names are compared with the RFC 1459 case mapping, like the channel directory:
+ *       an invitation to "#Chan" lets the client JOIN "#chan"
  */
 bool Client::get_channelInvitation(std::string &channel_name)
 {
 	for (size_t i = 0; i < this->_channels.size(); i++)
 	{
-		if (this->_channels[i] == channel_name)
+		if (ircCaseEqual(this->_channels[i], channel_name))
 			return true;
 	}
 	return false;
@@ -102,21 +166,128 @@ bool Client::get_channelInvitation(std::string &channel_name)
 /*      Utils     */
 /******************/
 
-void Client::clearBuffer() {_buffer.clear();}
 void Client::addChannelInvitation(std::string channel_name) {_channels.push_back(channel_name);}
 
 /**
  * @brief Removes a specific channel invitation from client's invitation list.
- * @param channel_name Name of channel invitation to remove
+ * @param channel_name Name of channel invitation to remove (case mapped, see get_channelInvitation())
  */
 void Client::removeChannelInvitation(std::string &channel_name)
 {
 	for (size_t i = 0; i < this->_channels.size(); i++)
 	{
-		if (this->_channels[i] == channel_name)
+		if (ircCaseEqual(this->_channels[i], channel_name))
 			{
 				this->_channels.erase(this->_channels.begin() + i);
 				return;
 			}
 	}
 }
+
+/**
+ * @brief Records that the client joined a channel (reverse index of Channel::_members).
+ * @param channel The joined channel, its address is stable (see Server::_channels)
+ */
+void Client::addJoinedChannel(Channel *channel) {_joined.push_back(channel);}
+
+/**
+ * @brief Forgets a channel the client left.
+ * @param channel The channel left
+ * @note O(channels joined): the last entry takes the place of the removed one
+ */
+void Client::removeJoinedChannel(Channel *channel)
+{
+	for (size_t i = 0; i < this->_joined.size(); i++)
+	{
+		if (this->_joined[i] == channel)
+		{
+			this->_joined[i] = this->_joined.back();
+			this->_joined.pop_back();
+			return;
+		}
+	}
+}
+
+
+/******************/
+/*   Send queue   */
+/******************/
+
+/**
+ * @brief Appends a reply to the outbound queue, keeping it for later flushing.
+ * @param data Bytes to send, already formatted for the wire (queued by reference, not copied)
+ * @param limit Maximum unsent bytes allowed for this client's class
+ * @return bool False if the reply would exceed the limit (the reply is not queued)
+ */
+bool Client::enqueueResponse(const SharedBuffer &data, size_t limit)
+{
+	if (data.empty())
+		return true;
+	if (_sendQueueBytes + data.size() > limit)
+		return false;
+	_sendQueue.push_back(data);
+	_sendQueueBytes += data.size();
+	if (_sendQueueBytes > _sendQueueHighWater)
+		_sendQueueHighWater = _sendQueueBytes;
+	return true;
+}
+
+/**
+ * @brief Discards every queued reply except a partially sent one and the ones being written.
+ * @note The partially sent reply is kept so the peer never sees a truncated line
+ * @note The _sendInFlight front entries are kept: the owner reactor is writing them without
+ *       the server lock and consumes them once its writev() returned (see Server::completeWrites())
+ */
+void Client::dropQueuedOutput()
+{
+	size_t keep = _sendOffset ? 1 : 0;
+	if (_sendInFlight > keep)
+		keep = _sendInFlight;
+	while (_sendQueue.size() > keep)
+	{
+		_sendQueueBytes -= _sendQueue.back().size();
+		_sendQueue.pop_back();
+	}
+}
+
+bool Client::hasPendingOutput() const {return !_sendQueue.empty();}
+
+/**
+ * @brief Describes the unsent queued replies as an iovec array for writev().
+ * @param iov Array to fill, oldest reply first (the first entry skips the bytes already sent)
+ * @param max Capacity of iov
+ * @return int Number of entries filled
+ */
+int Client::pendingIovecs(struct iovec *iov, int max) const
+{
+	int count = 0;
+	for (std::deque<SharedBuffer>::const_iterator it = _sendQueue.begin();
+		it != _sendQueue.end() && count < max; ++it, ++count)
+	{
+		size_t skip = (count == 0) ? _sendOffset : 0;
+		iov[count].iov_base = const_cast<char *>(it->data() + skip);
+		iov[count].iov_len = it->size() - skip;
+	}
+	return count;
+}
+
+/**
+ * @brief Drops bytes accepted by writev() from the front of the queue.
+ * @param bytes Number of bytes the kernel accepted (may span several queued replies)
+ */
+void Client::consumeOutput(size_t bytes)
+{
+	_sendQueueBytes -= bytes;
+	while (bytes > 0)
+	{
+		size_t left = _sendQueue.front().size() - _sendOffset;
+		if (bytes < left)
+		{
+			_sendOffset += bytes;
+			return;
+		}
+		bytes -= left;
+		_sendQueue.pop_front();
+		_sendOffset = 0;
+	}
+}
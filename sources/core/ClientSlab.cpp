@@ -0,0 +1,128 @@
+#include "../../includes/core/ClientSlab.hpp"
+
+ClientHandle::ClientHandle() : index(0), generation(0) {}
+
+ClientHandle::ClientHandle(unsigned int index, unsigned int generation) : index(index), generation(generation) {}
+
+bool ClientHandle::isNull() const {return this->generation == 0;}
+
+bool ClientHandle::operator==(ClientHandle const &other) const
+{
+	return this->index == other.index && this->generation == other.generation;
+}
+
+bool ClientHandle::operator!=(ClientHandle const &other) const {return !(*this == other);}
+
+
+ClientSlab::ClientSlab() : _size(0) {}
+
+ClientSlab::ClientSlab(ClientSlab const &copy) : _size(0)
+{
+	*this = copy;
+}
+
+ClientSlab& ClientSlab::operator=(ClientSlab const &copy)
+{
+	if (this != &copy)
+	{
+		clear();
+		for (size_t i = 0; i < copy._chunks.size(); i++)
+		{
+			Client *chunk = new Client[CLIENT_SLAB_CHUNK];
+			for (size_t j = 0; j < CLIENT_SLAB_CHUNK; j++)
+				chunk[j] = copy._chunks[i][j];
+			this->_chunks.push_back(chunk);
+		}
+		this->_generations = copy._generations;
+		this->_used = copy._used;
+		this->_free = copy._free;
+		this->_size = copy._size;
+	}
+	return (*this);
+}
+
+ClientSlab::~ClientSlab()
+{
+	clear();
+}
+
+void ClientSlab::clear()
+{
+	for (size_t i = 0; i < _chunks.size(); i++)
+		delete[] _chunks[i];
+	_chunks.clear();
+	_generations.clear();
+	_used.clear();
+	_free.clear();
+	_size = 0;
+}
+
+/**
+ * @brief Takes a free slot, allocating a new chunk when there is none.
+ * @return ClientHandle Handle of a default constructed Client
+ */
+ClientHandle ClientSlab::acquire()
+{
+	if (_free.empty())
+	{
+		size_t first = _generations.size();
+		_chunks.push_back(new Client[CLIENT_SLAB_CHUNK]);
+		_generations.resize(first + CLIENT_SLAB_CHUNK, 1);
+		_used.resize(first + CLIENT_SLAB_CHUNK, false);
+		for (size_t i = CLIENT_SLAB_CHUNK; i > 0; i--)
+			_free.push_back(first + i - 1); //lowest index on top
+	}
+	unsigned int index = _free.back();
+	_free.pop_back();
+	_used[index] = true;
+	_size++;
+	return ClientHandle(index, _generations[index]);
+}
+
+/**
+ * @brief Returns a client's slot to the free list; its handles become stale.
+ * @param handle Handle of the client, a stale or null handle is ignored
+ * @return void
+ * @note The Client is reset, releasing its strings, buffers and queued replies
+ */
+void ClientSlab::release(ClientHandle handle)
+{
+	Client *client = get(handle);
+	if (!client)
+		return;
+	*client = Client();
+	_used[handle.index] = false;
+	if (++_generations[handle.index] == 0) //never hand out generation 0
+		_generations[handle.index] = 1;
+	_free.push_back(handle.index);
+	_size--;
+}
+
+
+/*****************/
+/*    Getters    */
+/*****************/
+/**
+ * @brief Resolves a handle.
+ * @return Client* The client, or NULL if the handle is null or stale
+ */
+Client *ClientSlab::get(ClientHandle handle)
+{
+	if (handle.index >= _generations.size() || !_used[handle.index] || _generations[handle.index] != handle.generation)
+		return NULL;
+	return &_chunks[handle.index / CLIENT_SLAB_CHUNK][handle.index % CLIENT_SLAB_CHUNK];
+}
+
+/**
+ * @brief Client of a slot, to walk every client from 0 to capacity().
+ * @return Client* The client, or NULL if the slot is free
+ */
+Client *ClientSlab::at(size_t index)
+{
+	if (index >= _used.size() || !_used[index])
+		return NULL;
+	return &_chunks[index / CLIENT_SLAB_CHUNK][index % CLIENT_SLAB_CHUNK];
+}
+
+size_t ClientSlab::capacity() const {return this->_generations.size();}
+size_t ClientSlab::size() const {return this->_size;}
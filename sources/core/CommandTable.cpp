@@ -0,0 +1,70 @@
+#include "../../includes/core/Server.hpp"
+
+/**
+ * @brief Uppercases an ASCII letter, other bytes are returned unchanged.
+ */
+static inline unsigned char foldCase(char c)
+{
+	return (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c;
+}
+
+/**
+ * @brief Slot of a verb in Server::_commandTable.
+ * @details Perfect hash of the known verbs: the first and last letters, case folded,
+ * are enough to give each of them its own slot. Any other verb lands in some slot
+ * and is rejected by the string comparison in findCommand().
+ */
+static inline size_t commandSlot(const char *verb, size_t length)
+{
+	return (foldCase(verb[0]) + 6 * foldCase(verb[length - 1])) & (COMMAND_TABLE_SIZE - 1);
+}
+
+/**
+ * @brief Command dispatch table, indexed by commandSlot() of each verb.
+ * @note Adding a command means finding a slot (or new hash constants) that stays collision free
+ */
+const Server::CommandSpec Server::_commandTable[COMMAND_TABLE_SIZE] =
+{
+	/* 0 */ {"NICK", &Server::NICK, 0, 1, COST_FANOUT},
+	/* 1 */ {"USER", &Server::USER, 0, 4, COST_LIGHT},
+	/* 2 */ {"PASS", &Server::PASS, 0, 1, COST_LIGHT},
+	/* 3 */ {NULL, NULL, 0, 0, COST_LIGHT},
+	/* 4 */ {NULL, NULL, 0, 0, COST_LIGHT},
+	/* 5 */ {NULL, NULL, 0, 0, COST_LIGHT},
+	/* 6 */ {"TOPIC", &Server::TOPIC, CMD_NEEDS_REGISTRATION, 2, COST_FANOUT},
+	/* 7 */ {"INVITE", &Server::INVITE, CMD_NEEDS_REGISTRATION, 2, COST_DIRECT},
+	/* 8 */ {"PART", &Server::PART, CMD_NEEDS_REGISTRATION, 2, COST_FANOUT},
+	/* 9 */ {"QUIT", &Server::QUIT, 0, 1, COST_FANOUT}, //unregistered clients may quit too, see QUIT()
+	/* 10 */ {"PRIVMSG", &Server::PRIVMSG, CMD_NEEDS_REGISTRATION, 2, COST_FANOUT},
+	/* 11 */ {"MODE", &Server::MODE, CMD_NEEDS_REGISTRATION, MESSAGE_MAX_PARAMS, COST_FANOUT},
+	/* 12 */ {NULL, NULL, 0, 0, COST_LIGHT},
+	/* 13 */ {"KICK", &Server::KICK, CMD_NEEDS_REGISTRATION, 3, COST_FANOUT},
+	/* 14 */ {"JOIN", &Server::JOIN, CMD_NEEDS_REGISTRATION, 2, COST_FANOUT},
+	/* 15 */ {NULL, NULL, 0, 0, COST_LIGHT}
+};
+
+/**
+ * @brief Finds the dispatch table entry of a command verb.
+ * @param verb The verb as received, in any case (a view, it does not need to be terminated)
+ * @param length Length of the verb
+ * @return const CommandSpec* The entry, or NULL for an unknown command
+ *
+ * @details One hash, one slot, one comparison: no string is built and no tree is walked,
+ * unlike the two std::map<std::string, CommandHandler> lookups it replaces.
+ */
+const Server::CommandSpec *Server::findCommand(const char *verb, size_t length)
+{
+	if (length == 0)
+		return NULL;
+	const CommandSpec *spec = &_commandTable[commandSlot(verb, length)];
+	if (!spec->name)
+		return NULL;
+	for (size_t i = 0; i < length; i++)
+	{
+		if (spec->name[i] == '\0' || spec->name[i] != static_cast<char>(foldCase(verb[i])))
+			return NULL;
+	}
+	if (spec->name[length] != '\0')
+		return NULL;
+	return spec;
+}
@@ -0,0 +1,32 @@
+#include "../../includes/core/Server.hpp"
+
+/**
+ * @brief Channel mode descriptor table, one entry per mode letter MODE knows.
+ * @details Parsing (which letters take a parameter), permission checks and
+ * get_activeModes() all read it, so a mode that fits one of the ModeKind is added
+ * here and nowhere else. Entries are in the order get_activeModes() lists them.
+ */
+const ModeSpec Channel::_modeTable[CHANNEL_MODE_COUNT] =
+{
+	{'i', MODEKIND_FLAG, CHANMODE_INVITE_ONLY, MODEPARAM_NONE, MEMBER_OP},
+	{'t', MODEKIND_FLAG, CHANMODE_TOPIC_LOCK, MODEPARAM_NONE, MEMBER_OP},
+	{'k', MODEKIND_KEY, CHANMODE_KEY, MODEPARAM_ALWAYS, MEMBER_OP},
+	{'o', MODEKIND_MEMBER, MEMBER_OP, MODEPARAM_ALWAYS, MEMBER_OP},
+	{'l', MODEKIND_LIMIT, CHANMODE_LIMIT, MODEPARAM_ON_SET, MEMBER_OP},
+	{'v', MODEKIND_MEMBER, MEMBER_VOICE, MODEPARAM_ALWAYS, MEMBER_OP}
+};
+
+/**
+ * @brief Finds the descriptor of a mode letter.
+ * @param letter The mode letter as received (modes are case sensitive)
+ * @return const ModeSpec* The entry, or NULL for an unknown mode
+ */
+const ModeSpec *Channel::findMode(char letter)
+{
+	for (size_t i = 0; i < CHANNEL_MODE_COUNT; i++)
+	{
+		if (_modeTable[i].letter == letter)
+			return &_modeTable[i];
+	}
+	return NULL;
+}
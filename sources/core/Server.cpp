@@ -1,37 +1,103 @@
 #include "../../includes/core/Server.hpp"
 
+//Initialize the static global variable
+volatile sig_atomic_t Server::_signalRecieved = 0;
+
+ServerMetrics::ServerMetrics()
+{
+	this->sendqExceeded = 0;
+	this->fanouts = 0;
+	this->fanoutRecipients = 0;
+	this->fanoutBytesSerialized = 0;
+	this->commands = 0;
+	for (int i = 0; i < COST_COUNT; i++)
+		this->commandsByCost[i] = 0;
+	this->unknownCommands = 0;
+	this->repliesQueued = 0;
+	this->flushSyscalls = 0;
+	this->accepts = 0;
+	this->acceptTicks = 0;
+	this->acceptMaxPerTick = 0;
+	this->acceptCapHits = 0;
+	this->acceptEmfile = 0;
+	this->reads = 0;
+	this->bytesRead = 0;
+	this->readBudgetHits = 0;
+	this->linesTooLong = 0;
+	this->bytesQueued = 0;
+	this->colorBytes = 0;
+}
+
+Reactor::Reactor()
+{
+	this->index = 0;
+	this->listeningSocket = -1;
+	this->epollFd = -1;
+	this->wakeFd = -1;
+	this->wakePending = false;
+	this->started = false;
+	this->reads = 0;
+	this->bytesRead = 0;
+	this->readBudgetHits = 0;
+	this->server = NULL;
+}
+
+ScopedLock::ScopedLock(pthread_mutex_t &mutex) : _mutex(mutex)
+{
+	pthread_mutex_lock(&_mutex);
+}
+
+ScopedLock::~ScopedLock()
+{
+	pthread_mutex_unlock(&_mutex);
+}
+
 
 Server::Server(int port, std::string pass)
 {
 	this->_pass = pass;
 	this->_port = port;
-	this->_signalRecieved = false;
+	this->_signalRecieved = 0;
+	this->_stopping = false;
 	this->_listeningSocket = -1;
-
-	_registrationCommands["NICK"] = &Server::NICK;
-	_registrationCommands["USER"] = &Server::USER;
-	_registrationCommands["PASS"] = &Server::PASS;
-	_registrationCommands["QUIT"] = &Server::QUIT;
-	_channelCommands["JOIN"] = &Server::JOIN;
-	_channelCommands["PART"] = &Server::PART;
-	_channelCommands["PRIVMSG"] = &Server::PRIVMSG;
-	_channelCommands["TOPIC"] = &Server::TOPIC;
-	_channelCommands["INVITE"] = &Server::INVITE;
-	_channelCommands["KICK"] = &Server::KICK;
-	_channelCommands["MODE"] = &Server::MODE;
+#ifdef __linux__
+	this->_backend = BACKEND_EPOLL;
+#else
+	this->_backend = BACKEND_POLL;
+#endif
+	this->_threads = 1;
+	this->_output = OUTPUT_COLOR;
+	this->_trace = false;
+	this->_current = NULL;
+	pthread_mutex_init(&this->_lock, NULL);
+	this->_reserveFd = -1;
+	this->_fanoutEpoch = 0;
+	this->_sendqLimits[CLASS_UNREGISTERED] = SENDQ_DEFAULT_UNREGISTERED;
+	this->_sendqLimits[CLASS_USER] = SENDQ_DEFAULT_USER;
 }
 
 Server::Server(Server const &copy)
 {
 	this->_pass = copy._pass;
 	this->_port = copy._port;
-	this->_signalRecieved = copy._signalRecieved;
+	this->_stopping = false;
 	this->_listeningSocket = copy._listeningSocket;
+	this->_backend = copy._backend;
+	this->_output = copy._output;
+	this->_trace = copy._trace;
+	this->_threads = copy._threads;
+	this->_current = NULL; //reactors (threads, epoll instances) belong to the original server
+	pthread_mutex_init(&this->_lock, NULL);
+	this->_reserveFd = -1;
+	for (int i = 0; i < CLASS_COUNT; i++)
+		this->_sendqLimits[i] = copy._sendqLimits[i];
+	this->_metrics = copy._metrics;
+	this->_fanoutEpoch = copy._fanoutEpoch;
 	this->_fds = copy._fds;
 	this->_clients = copy._clients;
-	this->_channels = copy._channels;
-	this->_registrationCommands = copy._registrationCommands;
-  	this->_channelCommands = copy._channelCommands;
+	this->_clientSlots = copy._clientSlots;
+	this->_nicks = copy._nicks;
+	copyChannels(copy);
 }
 
 Server& Server::operator=(Server const &copy)
@@ -40,29 +106,58 @@ Server& Server::operator=(Server const &copy)
 	{
 		this->_pass = copy._pass;
 		this->_port = copy._port;
-		this->_signalRecieved = copy._signalRecieved;
 		this->_listeningSocket = copy._listeningSocket;
+		this->_backend = copy._backend;
+		this->_output = copy._output;
+		this->_trace = copy._trace;
+		this->_threads = copy._threads;
+		for (int i = 0; i < CLASS_COUNT; i++)
+			this->_sendqLimits[i] = copy._sendqLimits[i];
+		this->_metrics = copy._metrics;
+		this->_fanoutEpoch = copy._fanoutEpoch;
 		this->_fds = copy._fds;
 		this->_clients = copy._clients;
-		this->_channels = copy._channels;
-		this->_registrationCommands = copy._registrationCommands;
-  		this->_channelCommands = copy._channelCommands;
+		this->_clientSlots = copy._clientSlots;
+		this->_nicks = copy._nicks;
+		copyChannels(copy);
 	}
 	return(*this);
 }
 
 Server::~Server()
 {
-	for(size_t i = 0; i < _clients.size(); i++)
-		std::cout << YELLOW << "Client <" << _clients[i].get_fd()  << "> Disconnected" << RESET << std::endl;
+	for(size_t i = 0; i < _clients.capacity(); i++)
+	{
+		if (_clients.at(i))
+		{
+			std::cout << YELLOW << "Client <" << _clients.at(i)->get_fd()  << "> Disconnected" << RESET << std::endl;
+			if (_backend == BACKEND_EPOLL)
+				close(_clients.at(i)->get_fd()); //not in _fds with epoll, see addClient()
+		}
+	}
 
 	for (size_t i = 0; i < _fds.size(); i++)
 		close(_fds[i].fd);
+	for (size_t i = 0; i < _reactors.size(); i++)
+	{
+		if (_reactors[i]->epollFd >= 0)
+			close(_reactors[i]->epollFd);
+		if (_reactors[i]->wakeFd >= 0)
+			close(_reactors[i]->wakeFd);
+		delete _reactors[i];
+	}
+	if (_reserveFd >= 0)
+		close(_reserveFd);
+	pthread_mutex_destroy(&_lock);
 
+	for (ChannelMap::iterator it = _channels.begin(); it != _channels.end(); ++it)
+		delete it->second;
 	_channels.clear();
-	_clients.clear();
+	_clientSlots.clear();
 	_fds.clear();
 	this->_listeningSocket = -1;
+	_reactors.clear();
+	_current = NULL;
 }
 
 
@@ -71,17 +166,82 @@ Server::~Server()
 /******************/
 
 /**
- * @brief Initializes the server socket and prepares it for listening incoming connections (socket).
+ * @brief Creates the reactors and their listening sockets, preparing the server for incoming connections.
  * @return void
  *
+ * @details
+ * - BACKEND_POLL: a single reactor (the main thread), monitored through the _fds vector
+ * - BACKEND_EPOLL: _threads reactors, each with its own epoll instance, wake eventfd and
+ *   listening socket. With more than one reactor every listener sets SO_REUSEPORT so the kernel
+ *   spreads new connections across them instead of waking every thread for the same accept()
+ * - Every listening socket is added to _fds (closed by the destructor) and to its reactor's epoll
+ * - Opens _reserveFd, kept for shedding connections when the process runs out of fds
+ *
+ * @throws std::runtime_error If socket creation, configuration, binding or epoll setup fails
+ * @see createListeningSocket() for the socket itself
+ * @see execute() for the main server loop that uses these sockets
+ */
+void Server::init()
+{
+	if (_backend != BACKEND_EPOLL && _threads > 1)
+		throw(std::runtime_error("--threads requires the epoll backend"));
+
+	size_t count = (_backend == BACKEND_EPOLL) ? _threads : 1;
+	for (size_t i = 0; i < count; i++)
+	{
+		Reactor *reactor = new Reactor;
+		reactor->index = i;
+		reactor->server = this;
+		_reactors.push_back(reactor);
+
+		reactor->listeningSocket = createListeningSocket(count > 1);
+
+		//6. new node of the pollfd struct to add to the struct _fds. Here, it is configured how the poll function should behave with the assigned socket (the listening socket)
+		struct pollfd listenPollFd;
+		listenPollFd.fd = reactor->listeningSocket; //The socket to monitor: the listening socket
+		listenPollFd.events = POLLIN; //Events of interest: when there are new pending connections
+		listenPollFd.revents = 0; //Occurred events: initialized to zero
+
+		_fds.push_back(listenPollFd);
+
+		//7. With the epoll backend the kernel keeps the interest list, so the listening socket is registered once here
+#ifdef __linux__
+		if (_backend == BACKEND_EPOLL)
+		{
+			reactor->epollFd = epoll_create1(0);
+			if (reactor->epollFd < 0)
+				throw(std::runtime_error("Failed to create epoll instance"));
+			reactor->wakeFd = eventfd(0, EFD_NONBLOCK);
+			if (reactor->wakeFd < 0)
+				throw(std::runtime_error("Failed to create reactor wakeup eventfd"));
+			watchFd(reactor, reactor->wakeFd, false);
+		}
+#endif
+		watchFd(reactor, reactor->listeningSocket, false);
+	}
+	this->_listeningSocket = _reactors[0]->listeningSocket;
+	this->_current = _reactors[0];
+
+	//8. Spare descriptor, released when accept() fails with EMFILE so the pending connection can be shed
+	this->_reserveFd = open("/dev/null", O_RDONLY);
+	if (_reserveFd < 0)
+		throw(std::runtime_error("Failed to open the reserved file descriptor"));
+	fcntl(_reserveFd, F_SETFD, FD_CLOEXEC);
+}
+
+/**
+ * @brief Creates a non-blocking TCP socket listening on _port (socket).
+ * @param reusePort True to set SO_REUSEPORT, so that several reactors can listen on the same port
+ * @return int The listening socket
+ *
  * @details Creates and configures the TCP listening socket:
  * - Creates TCP IPv4 socket for incoming connections
  * - Sets SO_REUSEADDR to avoid "Address already in use" errors (setsockopt)
+ * - Sets SO_REUSEPORT when requested, the kernel then load-balances connections between the listeners
  * - Configures non-blocking mode for accept() operations (fcntl)
  * - Binds socket to specified port on all interfaces (bind)
  * - Starts listening for incoming connections (listen)
  * - Defines the address and port where the server will accept connections (sockaddr_in addr)
- * - Adds listening socket to poll monitoring array (pollfd listenPollFd)
  *
  * @throws std::runtime_error If socket creation, configuration, or binding fails
  * @note
@@ -91,22 +251,37 @@ Server::~Server()
  *	sockaddr_in addr --> struct used to indicate the IP address and port where the socket will listen
  *	bind --> associates the socket with the IP address and port set in the addr struct
  *	listen --> puts the socket into listening mode for incoming connections
- * @see execute() for the main server loop that uses this socket
  */
-void Server::init()
+int Server::createListeningSocket(bool reusePort)
 {
 	//1. Creates a new socket (fd) that uses the IPv4 address and the TCP protocol (to send/receive data reliably)
-	this->_listeningSocket = socket(AF_INET, SOCK_STREAM, 0);
-	if (_listeningSocket < 0)
+	int listeningSocket = socket(AF_INET, SOCK_STREAM, 0);
+	if (listeningSocket < 0)
 		throw(std::runtime_error("Failed to create socket"));
 
 	int enable = 1; //1 = true
-	if (setsockopt(_listeningSocket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) < 0)
+	if (setsockopt(listeningSocket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) < 0)
+	{
+		close(listeningSocket);
 		throw(std::runtime_error("Failed to set SO_REUSEADDR on listening socket"));
+	}
+	if (reusePort)
+	{
+#ifdef SO_REUSEPORT
+		if (setsockopt(listeningSocket, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0)
+#endif
+		{
+			close(listeningSocket);
+			throw(std::runtime_error("Failed to set SO_REUSEPORT on listening socket"));
+		}
+	}
 
 	//2. when accept() is called and there are no connections waiting, instead of blocking, it returns an error.
-	if (fcntl(_listeningSocket, F_SETFL, O_NONBLOCK) < 0)
+	if (fcntl(listeningSocket, F_SETFL, O_NONBLOCK) < 0)
+	{
+		close(listeningSocket);
 		throw(std::runtime_error("Failed to set non-blocking mode on listening socket"));
+	}
 
 	//3. Create a new sockaddr_in structure element to specify which IP address and port this socket should be ‘bound’ to
 	struct sockaddr_in addr;
@@ -116,38 +291,60 @@ void Server::init()
 	addr.sin_addr.s_addr = INADDR_ANY; //Listen on all interfaces (all IPs of the server)
 	memset(addr.sin_zero, 0, sizeof(addr.sin_zero)); //Clears the padding bytes to avoid garbage in the structure
 
-	//4. Bind _listeningSocket to the IP and port specified in addr
-	if (bind(_listeningSocket, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+	//4. Bind listeningSocket to the IP and port specified in addr
+	if (bind(listeningSocket, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+	{
+		close(listeningSocket);
 		throw(std::runtime_error("Failed to bind socket"));
+	}
 
 	//5. Set the socket to listening mode for incoming connections
-	if (listen(_listeningSocket, SOMAXCONN) < 0)
+	if (listen(listeningSocket, SOMAXCONN) < 0)
+	{
+		close(listeningSocket);
 		throw(std::runtime_error("Listen failed"));
+	}
+	return listeningSocket;
+}
 
-	//6. new node of the pollfd struct to add to the struct _fds. Here, it is configured how the poll function should behave with the assigned socket (the listening socket)
-	struct pollfd listenPollFd;
-	listenPollFd.fd = this->_listeningSocket; //The socket to monitor: the listening socket
-	listenPollFd.events = POLLIN; //Events of interest: when there are new pending connections
-	listenPollFd.revents = 0; //Occurred events: initialized to zero
-
-	_fds.push_back(listenPollFd);
+/**
+ * @brief Main server execution loop, dispatches to the selected readiness backend.
+ * @return void
+ *
+ * @details Monitors all sockets for activity and dispatches events:
+ * - BACKEND_POLL: executePoll(), poll() over the whole _fds vector
+ * - BACKEND_EPOLL: executeEpoll(), only ready fds are returned by the kernel
+ * - Continues until signal is received to stop server
+ *
+ * @throws std::runtime_error If the backend wait call fails
+ * @see NewClient() for handling new connections
+ * @see NewData() for processing client data
+ */
+void Server::execute()
+{
+	if (_backend == BACKEND_EPOLL)
+		executeEpoll();
+	else
+		executePoll();
 }
 
 /**
- * @brief Main server execution loop using poll() for handling multiple clients.
+ * @brief Event loop using poll() for handling multiple clients.
  * @return void
  *
  * @details Monitors all sockets for activity and dispatches events:
  * - Uses poll() to wait for activity on any monitored socket
  * - Handles new client connections on listening socket
+ * - Flushes queued replies of clients whose socket became writable (POLLOUT)
  * - Processes incoming data from existing clients
+ * - Flushes every client that got replies during this iteration, one writev() each
  * - Continues until signal is received to stop server
  *
+ * @note Every wakeup costs O(connections): the whole _fds vector is handed to the kernel and walked afterwards
+ * @note Always single-threaded: the only reactor is _reactors[0], without epoll instance nor wakeup eventfd
  * @throws std::runtime_error If poll() system call fails
- * @see NewClient() for handling new connections
- * @see NewData() for processing client data
  */
-void Server::execute()
+void Server::executePoll()
 {
 	while (_signalRecieved == false)
 	{
@@ -159,73 +356,411 @@ void Server::execute()
 
 		for(size_t i = 0; i < _fds.size(); i++)
 		{
-			if(_fds[i].revents && POLLIN)
+			int fd = _fds[i].fd;
+			short revents = _fds[i].revents;
+			if(revents & POLLOUT)
+				flushSendQueue(get_client(fd));
+			if(revents & (POLLIN | POLLHUP | POLLERR))
 			{
-				if(_fds[i].fd == _listeningSocket)
+				if(fd == _listeningSocket)
 					NewClient();
 				else
-					NewData(_fds[i].fd);
+					NewData(fd);
 			}
 		}
+		flushPendingClients();
+		closeQuittingClients();
+		_current->arena.reset();
+	}
+}
+
+/**
+ * @brief Runs every epoll reactor: _reactors[0] on the calling thread, the others on their own threads.
+ * @return void
+ *
+ * @details
+ * - Reactor threads are created with SIGINT/SIGTERM blocked, so signals always reach the main thread
+ * - When the main reactor stops (signal or exception), stopReactors() wakes and joins the others
+ *
+ * @throws std::runtime_error If a reactor thread cannot be created or epoll_wait() fails
+ * @see runReactor() for the loop itself
+ */
+void Server::executeEpoll()
+{
+#ifdef __linux__
+	sigset_t blocked, previous;
+	sigemptyset(&blocked);
+	sigaddset(&blocked, SIGINT);
+	sigaddset(&blocked, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+	for (size_t i = 1; i < _reactors.size(); i++)
+	{
+		if (pthread_create(&_reactors[i]->thread, NULL, &Server::reactorThread, _reactors[i]) != 0)
+		{
+			pthread_sigmask(SIG_SETMASK, &previous, NULL);
+			stopReactors();
+			throw(std::runtime_error("Failed to start reactor thread"));
+		}
+		_reactors[i]->started = true;
+	}
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+	try
+	{
+		runReactor(_reactors[0]);
+	}
+	catch (...)
+	{
+		stopReactors();
+		throw;
+	}
+	stopReactors();
+#else
+	executePoll();
+#endif
+}
+
+/**
+ * @brief Event loop of one reactor using Linux epoll, only ready sockets are visited.
+ * @param reactor The reactor to run, it only handles the clients it accepted
+ * @return void
+ *
+ * @details Sockets are registered once (init() / NewClient()) and removed in RemoveFd(),
+ * so each wakeup costs O(ready fds) instead of O(connections). _lock is only held while
+ * shared state (clients, channels, send queues, metrics) is used, the socket I/O runs without it:
+ * 1. epoll_wait() returns at most EPOLL_MAX_EVENTS ready fds
+ * 2. Without _lock: the ready clients are read into their LineFramer (receiveData()); only this
+ *    thread reads or closes its clients, and it finds them through Reactor::clients
+ * 3. With _lock: accepts, runs the lines of the clients that hung up then closes them, parses and runs the received lines,
+ *    then snapshots the queued replies as iovecs (prepareWrites())
+ * 4. Without _lock: one writev() per client with replies (performWrites())
+ * 5. With _lock: the written bytes leave the send queues (completeWrites()), then the clients
+ *    flagged as quitting before step 4 are closed
+ *
+ * - The listening socket is level-triggered: NewClient() drains it, up to ACCEPT_MAX_PER_TICK per event
+ * - Client sockets are edge-triggered: NewData() drains them until EAGAIN, or until the read budget
+ *   runs out; those clients are read again on the next iteration, which then does not block
+ * - The wakeup eventfd signals replies queued by other reactors for clients of this one
+ * - EPOLLOUT is only requested while a client has queued replies (see setWriteInterest())
+ * - Replies produced while handling the ready fds are flushed once per client at the end
+ *
+ * @throws std::runtime_error If epoll_wait() fails for a reason other than a signal
+ * @see watchFd() for the registration of each socket
+ * @see scheduleFlush() for the cross-reactor handoff
+ */
+void Server::runReactor(Reactor *reactor)
+{
+#ifdef __linux__
+	std::vector<struct epoll_event> events(EPOLL_MAX_EVENTS);
+	std::vector<int> readable; //owned fds read during this iteration, their lines are parsed under _lock
+	std::vector<int> hungUp; //owned fds whose peer closed the connection (or whose recv() failed)
+	std::vector<int> writable; //owned fds reported by EPOLLOUT
+	std::vector<int> closing; //pendingClose as it was before the writes of this iteration
+	std::vector<PendingWrite> writes;
+	std::vector<struct iovec> iovecs;
+	bool moreOutput = false; //a writev() was filled up and more replies are queued
+
+	while (true)
+	{
+		int timeout = (reactor->pendingReads.empty() && !moreOutput) ? -1 : 0; //data left to read or to write
+		int ready = epoll_wait(reactor->epollFd, &events[0], events.size(), timeout);
+		if (ready < 0 && errno != EINTR)
+			throw(std::runtime_error("epoll_wait failed"));
+
+		//1. Without _lock: read the ready clients, and the ones whose read budget ran out, into their framers
+		readable.clear();
+		hungUp.clear();
+		writable.clear();
+		for (size_t i = 0; i < reactor->pendingReads.size(); i++)
+		{
+			int fd = reactor->pendingReads[i];
+			Client *client = reactor->clients[fd];
+			if (!client || !client->get_readPending())
+				continue; //closed since it was listed
+			client->set_readPending(false);
+			readable.push_back(fd);
+		}
+		reactor->pendingReads.clear();
+		for (int i = 0; i < ready; i++)
+		{
+			int fd = events[i].data.fd;
+			if (fd == reactor->listeningSocket || fd == reactor->wakeFd
+				|| static_cast<size_t>(fd) >= reactor->clients.size() || !reactor->clients[fd])
+				continue;
+			if (events[i].events & EPOLLOUT)
+				writable.push_back(fd);
+			if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+				readable.push_back(fd);
+		}
+		for (size_t i = 0; i < readable.size(); i++)
+		{
+			if (!receiveData(reactor, reactor->clients[readable[i]]))
+				hungUp.push_back(readable[i]);
+		}
 
-		// Procesar clientes marcados para QUIT
-		std::vector<Client>::iterator it;
-		for(it = _clients.begin(); it != _clients.end(); it++)
+		//2. With _lock: accept, run the received commands and snapshot the queued replies
 		{
-		    if (it->get_isQuitting())
-		    {
-		        ft_close(it->get_fd());
-		        std::cout << YELLOW << "Client fd " << it->get_fd() << " disconnected\n" << RESET;
-		        break;
-		    }
+			ScopedLock guard(_lock);
+			if (reactor == _reactors[0] && _signalRecieved)
+				_stopping = true; //signals are only delivered to the main thread, which runs _reactors[0]
+			if (_stopping)
+				break;
+			_current = reactor;
+			addReadCounters(reactor);
+			for (size_t i = 0; i < hungUp.size(); i++)
+			{
+				if (!get_client(hungUp[i]))
+					continue; //listed twice
+				parseLines(hungUp[i]); //the lines received before the close still run
+				if (!get_client(hungUp[i]))
+					continue; //closed by its own QUIT
+				std::cerr << RED << "Connection closed or error on client's fd " << hungUp[i] << RESET << std::endl;
+				ft_close(hungUp[i]);
+			}
+			for (size_t i = 0; i < readable.size(); i++)
+				parseLines(readable[i]);
+			for (int i = 0; i < ready; i++)
+			{
+				int fd = events[i].data.fd;
+				if (fd == reactor->listeningSocket)
+					NewClient();
+				else if (fd == reactor->wakeFd)
+				{
+					eventfd_t value;
+					eventfd_read(reactor->wakeFd, &value);
+					reactor->wakePending = false;
+				}
+			}
+			closing.swap(reactor->pendingClose); //clients flagged from now on get their last replies flushed first
+			prepareWrites(reactor, writable, writes, iovecs);
+			_current = NULL;
 		}
+
+		//3. Without _lock: write the snapshot
+		performWrites(writes, iovecs);
+
+		//4. With _lock: drop what was written, close the clients flagged before the writes
+		ScopedLock guard(_lock);
+		_current = reactor;
+		moreOutput = completeWrites(writes);
+		closeClients(closing);
+		reactor->arena.reset();
+		_current = NULL;
+	}
+#else
+	(void)reactor;
+#endif
+}
+
+/**
+ * @brief Thread entry point of the reactors other than _reactors[0].
+ * @param arg The Reactor to run
+ * @return void* Always NULL
+ * @note An exception stops the whole server: it is logged and the main reactor is woken up
+ */
+void *Server::reactorThread(void *arg)
+{
+	Reactor *reactor = static_cast<Reactor*>(arg);
+	try
+	{
+		reactor->server->runReactor(reactor);
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << RED << "Reactor " << reactor->index << ": " << e.what() << RESET << std::endl;
+		ScopedLock guard(reactor->server->_lock);
+		reactor->server->_stopping = true;
+		reactor->server->wakeReactor(reactor->server->_reactors[0]);
+	}
+	return NULL;
+}
+
+/**
+ * @brief Asks every reactor to stop and waits for the reactor threads to finish.
+ * @return void
+ * @note Called by the main thread once its own reactor returned
+ */
+void Server::stopReactors()
+{
+	{
+		ScopedLock guard(_lock);
+		_stopping = true;
+		for (size_t i = 1; i < _reactors.size(); i++)
+			wakeReactor(_reactors[i]);
+	}
+	for (size_t i = 1; i < _reactors.size(); i++)
+	{
+		if (_reactors[i]->started)
+			pthread_join(_reactors[i]->thread, NULL);
+		_reactors[i]->started = false;
 	}
 }
 
 /**
- * @brief Accepts a new client connection and creates a Client object.
+ * @brief Drains the accept queue of the current reactor's listening socket, creating a Client for each connection.
  * @return void
  *
  * @details Handles the complete process of accepting new connections:
- * - Accepts incoming connection on listening socket (accept)
- * - Sets new socket to non-blocking mode (fcntl)
- * - Creates new node of the pollfd struct for the new Client instance with socket details
- * - Adds client to monitoring list with poll()
- * - Logs connection event for debugging
+ * - Loops on accept4(SOCK_NONBLOCK | SOCK_CLOEXEC) until EAGAIN, so a reconnect storm does not cost one wakeup per client
+ * - Stops after ACCEPT_MAX_PER_TICK connections; the listener is level-triggered, the rest is accepted on the next iteration
+ * - EMFILE/ENFILE: the reserved fd is released to accept and close the pending connection, then re-opened
+ *   (otherwise the level-triggered listener would report the same connection forever)
+ * - Transient errors (ECONNABORTED, EINTR, ...) are logged and never stop the server
+ * - Counts accepts per iteration in ServerMetrics
  *
- * @throws std::runtime_error If accept() fails or socket configuration fails
  * @note Client begins in unregistered state and must complete authentication
- * - accept --> Extracts the first pending connection from the listening socket's queue and
- *              returns a new socket file descriptor connected to the client.
- * - fcntl --> Sets the newly accepted client socket to non-blocking mode so that read/write
- *             operations will not block the server loop.
- * @see Client() constructor for initial client setup
+ * - accept4 --> Extracts the first pending connection from the listening socket's queue and
+ *               returns a new socket file descriptor, already non-blocking and close-on-exec.
+ * @see addClient() for the registration of each accepted socket
  */
 void Server::NewClient()
 {
-	struct sockaddr_in clientAddr;
-	memset(&clientAddr, 0, sizeof(clientAddr));
-	socklen_t addrLen = sizeof(clientAddr);
-	int clientSocket = accept(_listeningSocket, (struct sockaddr*)&clientAddr, &addrLen);
+	size_t accepted = 0;
+	size_t shed = 0;
+	while (accepted + shed < ACCEPT_MAX_PER_TICK)
+	{
+		struct sockaddr_in clientAddr;
+		memset(&clientAddr, 0, sizeof(clientAddr));
+		socklen_t addrLen = sizeof(clientAddr);
+		int clientSocket = acceptConnection(_current->listeningSocket, clientAddr, addrLen);
+		if (clientSocket >= 0)
+		{
+			addClient(clientSocket, clientAddr);
+			accepted++;
+			continue;
+		}
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+			break; //accept queue drained
+		if (errno == EINTR || errno == ECONNABORTED)
+			continue; //the peer gave up before we accepted it
+		if (errno == EMFILE || errno == ENFILE)
+		{
+			if (!shedConnection())
+				break; //nothing pending, or no reserve to shed with
+			shed++;
+			continue;
+		}
+		std::cerr << RED << "accept() failed: " << strerror(errno) << RESET << std::endl;
+		break;
+	}
+
+	if (accepted + shed == ACCEPT_MAX_PER_TICK)
+		_metrics.acceptCapHits++;
+	if (accepted == 0)
+		return;
+	_metrics.accepts += accepted;
+	_metrics.acceptTicks++;
+	if (accepted > _metrics.acceptMaxPerTick)
+		_metrics.acceptMaxPerTick = accepted;
+}
+
+/**
+ * @brief accept() returning a non-blocking, close-on-exec socket.
+ * @param listeningSocket The socket to accept from
+ * @param clientAddr Filled with the peer address
+ * @param addrLen Size of clientAddr
+ * @return int The connected socket, or -1 with errno set
+ * @note accept4() is Linux-only; elsewhere accept() is followed by fcntl()
+ */
+int Server::acceptConnection(int listeningSocket, struct sockaddr_in &clientAddr, socklen_t &addrLen)
+{
+#ifdef __linux__
+	return accept4(listeningSocket, (struct sockaddr*)&clientAddr, &addrLen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+	int clientSocket = accept(listeningSocket, (struct sockaddr*)&clientAddr, &addrLen);
+	if (clientSocket < 0)
+		return -1;
+	if (fcntl(clientSocket, F_SETFL, O_NONBLOCK) < 0 || fcntl(clientSocket, F_SETFD, FD_CLOEXEC) < 0)
+	{
+		int error = errno;
+		close(clientSocket);
+		errno = error;
+		return -1;
+	}
+	return clientSocket;
+#endif
+}
+
+/**
+ * @brief Accepts and immediately closes one pending connection when the process is out of fds.
+ * @return bool True if a connection was shed, false if the accept queue was empty (Linux reports
+ *         EMFILE before looking at the queue) or the reserved fd is not available
+ *
+ * @details The reserved fd (/dev/null, opened by init()) is closed to make room for accept(),
+ * the connection is closed right away and the reserve is opened again. The client sees a
+ * clean close instead of hanging in the backlog, and the listener stops reporting it.
+ */
+bool Server::shedConnection()
+{
+	if (_reserveFd < 0)
+	{
+		std::cerr << RED << "Out of file descriptors and no reserved fd left" << RESET << std::endl;
+		return false;
+	}
+	close(_reserveFd);
+	int clientSocket = accept(_current->listeningSocket, NULL, NULL);
+	if (clientSocket >= 0)
+		close(clientSocket);
+	_reserveFd = open("/dev/null", O_RDONLY);
+	if (_reserveFd >= 0)
+		fcntl(_reserveFd, F_SETFD, FD_CLOEXEC);
 	if (clientSocket < 0)
-		throw(std::runtime_error("Failed to accept a client"));
+		return false;
 
-	//1. Set the client socket to non-blocking mode”
-	if (fcntl(clientSocket, F_SETFL, O_NONBLOCK) < 0)
-		throw(std::runtime_error("Failed to set non-blocking mode on client socket"));
+	_metrics.acceptEmfile++;
+	std::cerr << RED << "Out of file descriptors, refused a connection" << RESET << std::endl;
+	return true;
+}
 
-	//2. new pollfd node to add to the _fds vector
-	struct pollfd newClientPollFd;
-	newClientPollFd.fd = clientSocket; //the socket to monitor: clientSocket
-	newClientPollFd.events = POLLIN; //Events of interest: data sent by the client
-	newClientPollFd.revents = 0; //Occurred events: initialized to zero.
-	_fds.push_back(newClientPollFd);
+/**
+ * @brief Registers an accepted socket: pollfd node, epoll interest and Client object.
+ * @param clientSocket The connected, non-blocking socket
+ * @param clientAddr The peer address
+ * @return void
+ *
+ * @details
+ * - Creates new node of the pollfd struct for the new Client instance with socket details
+ * - Adds client to monitoring list with poll(), or registers it once in the epoll interest list of the current reactor
+ *   (with epoll, _fds only holds the listening sockets, so RemoveFd() has nothing to scan)
+ * - Logs connection event for debugging
+ *
+ * @see Client() constructor for initial client setup
+ */
+void Server::addClient(int clientSocket, const struct sockaddr_in &clientAddr)
+{
+	//1. new pollfd node to add to the _fds vector (poll), or epoll interest of the current reactor
+	if (_backend == BACKEND_POLL)
+	{
+		struct pollfd newClientPollFd;
+		newClientPollFd.fd = clientSocket; //the socket to monitor: clientSocket
+		newClientPollFd.events = POLLIN; //Events of interest: data sent by the client
+		newClientPollFd.revents = 0; //Occurred events: initialized to zero.
+		_fds.push_back(newClientPollFd);
+	}
+	try
+	{
+		watchFd(_current, clientSocket, true);
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << RED << e.what() << ", closing fd " << clientSocket << RESET << std::endl;
+		close(clientSocket);
+		return;
+	}
 
-	//3. new client node to add to the _clients vector
-	Client newClient;
-	newClient.set_fd(clientSocket);
-	newClient.set_IPaddress(inet_ntoa((clientAddr.sin_addr))); //inet_ntoa --> Convert the binary IPv4 address (in_addr) into a readable string
-	_clients.push_back(newClient);
+	//2. new client taken from the _clients slab, owned by the reactor that accepted it
+	ClientHandle handle = _clients.acquire();
+	Client *newClient = _clients.get(handle);
+	newClient->set_fd(clientSocket);
+	newClient->set_handle(handle);
+	newClient->set_reactor(_current->index);
+	newClient->set_IPaddress(inet_ntoa((clientAddr.sin_addr))); //inet_ntoa --> Convert the binary IPv4 address (in_addr) into a readable string
+	if (static_cast<size_t>(clientSocket) >= _clientSlots.size())
+		_clientSlots.resize(clientSocket + 1);
+	_clientSlots[clientSocket] = handle;
+	if (static_cast<size_t>(clientSocket) >= _current->clients.size())
+		_current->clients.resize(clientSocket + 1, NULL);
+	_current->clients[clientSocket] = newClient;
 
 	std::cout << YELLOW << "Client connected: fd " << clientSocket << RESET << std::endl;
 }
@@ -235,199 +770,318 @@ void Server::NewClient()
  * @param clientFd The file descriptor of the client socket to read from
  * @return void
  *
- * @details Handles all aspects of client data processing:
- * - Receives data from client socket using recv()
- * - Detects client disconnections (recv returns 0)
- * - Handles socket errors and close the socket and remove it from _fds.
- * - Accumulates partial IRC messages in client buffer
- * - Parses complete messages and executes IRC commands
- * - Manages client cleanup on disconnection or errors
+ * @details Used by the poll loop, the epoll reactors call both halves separately:
+ * - receiveData() fills the client's LineFramer
+ * - parseLines() runs every complete line, also when the peer closed right after sending them
+ * - Detects client disconnections (recv returns 0) and socket errors, and then closes the client
  *
- * @throws std::runtime_error If socket operations fail unexpectedly
- * @note IRC messages may arrive in multiple packets and need buffering
- * @see parser() for IRC message parsing logic
+ * @see receiveData() and parseLines()
  */
 void Server::NewData(int clientFd)
 {
-	char buffer[1024];
-	memset(buffer, 0, sizeof(buffer));
-	size_t bytesReceived = recv(clientFd, buffer, sizeof(buffer) - 1, 0);
+	Client* currentClient = this->get_client(clientFd);
+	if (!currentClient)
+		return; //stale event: the client was closed earlier in this loop iteration
 
-	if (bytesReceived <= 0) //The client closed the connection or an error occurred
+	bool open = receiveData(_current, currentClient);
+	addReadCounters(_current);
+	parseLines(clientFd); //before a close: "JOIN #c\r\nPRIVMSG #c :bye\r\n" then EOF still runs both lines
+	if (!open && get_client(clientFd))
 	{
 		std::cerr << RED << "Connection closed or error on client's fd " << clientFd << RESET << std::endl;
 		ft_close(clientFd);
-		return;
 	}
-	buffer[bytesReceived] = '\0';
-
-	Client* currentClient = this->get_client(clientFd);
-	if (!currentClient)
-		throw std::runtime_error("error client doesn't exist");
-
-	//1. Accumulate the received data in the client’s private buffer, DO NOT overwrite
-	currentClient->set_buffer(buffer);
-	const std::string& accumulatedBuffer = currentClient->get_buffer();
-	//std::cout << "DEBUG: Accumulated buffer for fd " << clientFd << ": " << GREEN << accumulatedBuffer << RESET << std::endl; //💡 to test fragmented commands
+}
 
-	//2. Check if the accumulated buffer contains one or more complete commands ending with \r\n
-	if (accumulatedBuffer.find("\r\n") == std::string::npos)
-		return; //If not found, return to poll() to wait for more data; it is not the end of the IRC command.
+/**
+ * @brief Receives the available data of a client into its LineFramer.
+ * @param reactor The reactor that owns the client, its read counters are updated
+ * @param client The client to read
+ * @return bool False if the peer closed the connection or recv() failed: the caller runs the lines
+ *         committed before it (parseLines()), then closes the client
+ *
+ * @details
+ * - Receives data with recv() straight into the client's reusable read buffer, until it would block
+ *   or READ_BUDGET_PER_EVENT bytes were read (the client is then listed in pendingReads, see scheduleRead())
+ * - Keeps partial IRC messages in the framer until their line terminator arrives
+ *
+ * @note Runs without _lock in the epoll reactors: it only touches the client's framer and read
+ *       flag and the reactor's own counters, which no other thread uses
+ * @note IRC messages may arrive in multiple packets and need buffering
+ */
+bool Server::receiveData(Reactor *reactor, Client *client)
+{
+	//Drain the socket until EAGAIN (required by the edge-triggered epoll backend), within the fairness budget
+	size_t budget = READ_BUDGET_PER_EVENT;
+	while (true)
+	{
+		if (budget == 0)
+		{
+			reactor->readBudgetHits++;
+			scheduleRead(client);
+			return true;
+		}
+		size_t available;
+		char *space = client->get_framer().writeSpace(READ_CHUNK_SIZE, available);
+		ssize_t bytesReceived = recv(client->get_fd(), space, std::min(available, budget), 0);
 
-	//3. Split all complete commands in the accumulated buffer
-	std::vector<std::string> commands = split_receivedBuffer(accumulatedBuffer);
-	currentClient->set_cmd(commands); //Each command is always delimited by \r\n
+		if (bytesReceived < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return true; //nothing left to read for now
+		if (bytesReceived < 0 && errno == EINTR)
+			continue;
+		if (bytesReceived <= 0) //The client closed the connection or an error occurred
+			return false;
+		client->get_framer().commit(bytesReceived);
+		budget -= bytesReceived;
+		reactor->reads++;
+		reactor->bytesRead += bytesReceived;
+	}
+}
 
-	//4. Parse each command
-	for (size_t i = 0; i < currentClient->get_cmd().size(); i++)
-		this->parser(currentClient->get_cmd()[i], clientFd);
+/**
+ * @brief Runs every complete line buffered in a client's LineFramer.
+ * @param clientFd The file descriptor of the client
+ * @return void
+ *
+ * @details
+ * - Hands every complete line to parser() as a view into the framer's storage
+ * - Answers 417 to lines over IRC_LINE_MAX bytes, which are dropped
+ * - Stops parsing once the client was closed (QUIT) or flagged as quitting
+ *
+ * @see parser() for IRC message parsing logic
+ */
+void Server::parseLines(int clientFd)
+{
+	Client* currentClient = this->get_client(clientFd);
+	if (!currentClient)
+		return; //closed earlier in this loop iteration
 
-	//5. Clean the client's buffer after parsing
-	currentClient->clearBuffer();
+	//Parse each complete command (delimited by \r\n or \n); a trailing partial command stays buffered
+	const char *line;
+	size_t length;
+	LineFramer::Status status;
+	while ((status = currentClient->get_framer().next(line, length)) != LineFramer::LINE_NONE)
+	{
+		if (status == LineFramer::LINE_TOO_LONG)
+		{
+			_metrics.linesTooLong++;
+			std::string nickname = currentClient->get_nickname().empty() ? "*" : currentClient->get_nickname();
+			_sendResponse(ERROR_INPUT_TOO_LONG(nickname), clientFd);
+			continue;
+		}
+		this->parser(line, length, clientFd);
+		currentClient = this->get_client(clientFd); //QUIT closes the client, any command may flag it as quitting
+		if (!currentClient || currentClient->get_isQuitting())
+			return;
+	}
 }
 
 /**
  * @brief Parses and executes IRC commands received from clients.
- * @param command The raw IRC command string received from client
+ * @param line The raw IRC command received from client (a view into its read buffer, without terminator)
+ * @param length Length of the command
  * @param fd The file descriptor of the client who sent the command
  * @return void
  *
  * @details Implements complete IRC command processing pipeline:
- * - Normalizes and validates command format
- * - Splits command into tokens (command + parameters)
- * - Converts command to uppercase for case-insensitive matching
- * - Maps command strings to appropriate command handler objects
- * - Executes command with proper authentication checks
+ * - Trims surrounding whitespace on the view and ignores empty lines
+ * - Parses the line once into a Message (prefix, command, parameters), without copying it
+ * - Finds the handler in the static dispatch table, case folding is done while hashing
+ * - Checks registration once, for every command flagged CMD_NEEDS_REGISTRATION
+ * - Answers an unknown command with 421, its verb uppercased in the reactor's arena
+ * - Caps the parameters to the command's maxParams and executes the handler
  * - Supports all IRC commands: PASS, NICK, USER, JOIN, PART, PRIVMSG, etc.
  *
  * @note Commands are processed through Command Pattern for maintainability
  * @note Invalid commands are silently ignored (IRC specification)
  * @see ICommand interface for command implementation structure
- * @see split_cmd() for command tokenization logic
+ * @see Message::parse() for command tokenization logic
+ * @see findCommand() for the dispatch table
  */
-void Server::parser(const std::string &command, int fd)
+void Server::parser(const char *line, size_t length, int fd)
 {
-	std::string cmd = normalize_param(command, false);
-	if(cmd.empty())
+	//0. Trim the view and split it into prefix, command and parameters (views, nothing is copied)
+	size_t start = 0;
+	while (start < length && strchr(" \t\r\n", line[start]))
+		start++;
+	while (length > start && strchr(" \t\r\n", line[length - 1]))
+		length--;
+	Message msg;
+	if (!msg.parse(line + start, length - start))
 		return;
+	_metrics.commands++;
 
-	std::vector<std::string> commands = split_cmd(cmd);
-
-	//1. normalize letters from command token to capital letters
-	for (size_t i = 0; i < commands[0].size(); i++)
-		commands[0][i] = toupper(commands[0][i]);
-
-	std::string cmdName = commands[0];
+	//1. Look the command up (case insensitive, without copying it)
+	const CommandSpec *spec = findCommand(msg.commandData(), msg.commandLength());
 
-	//2. Check command registration
-	std::map<std::string, CommandHandler>::iterator it = _registrationCommands.find(cmdName);
-	if (it != _registrationCommands.end())
+	//2. Channel commands, and unknown ones, need a registered client that is logged in
+	if (!spec || (spec->flags & CMD_NEEDS_REGISTRATION))
 	{
-		CommandHandler handler = it->second;
-		(this->*handler)(cmd, fd);
-		return;
-	}
-
-	//3. Check if the user is registered for channel commands and is logged in
-	if (isregistered(fd) && get_client(fd)->get_logedIn())
-	{
-		std::map<std::string, CommandHandler>::iterator it2 = _channelCommands.find(cmdName);
-		if (it2 != _channelCommands.end())
+		if (!isregistered(fd) || !get_client(fd)->get_logedIn())
 		{
-			CommandHandler handler = it2->second;
-			(this->*handler)(cmd, fd);
+			_sendResponse(ERROR_NOT_REGISTERED_YET(std::string("*")), fd);
+			return;
 		}
-		else
-			_sendResponse(ERROR_COMMAND_NOT_RECOGNIZED(get_client(fd)->get_nickname(), cmdName), fd);
 	}
-	else
-		_sendResponse(ERROR_NOT_REGISTERED_YET(std::string("*")), fd);
-}
+	if (!spec)
+	{
+		_metrics.unknownCommands++;
+		ArenaString cmdName(msg.commandData(), msg.commandLength(), ArenaAllocator<char>(get_arena()));
+		for (size_t i = 0; i < cmdName.size(); i++)
+			cmdName[i] = toupper(cmdName[i]);
+		ReplyBuilder reply;
+		replyCommandNotRecognized(reply, get_client(fd)->get_nickname(), cmdName);
+		sendReply(reply, fd);
+		return;
+	}
 
+	//3. Execute the handler
+	msg.limitParams(spec->maxParams);
+	_metrics.commandsByCost[spec->cost]++;
+	(this->*spec->handler)(msg, fd);
+}
 
-// Method to split the buffer using the "\r\n" delimiter
 
 /**
- * @brief Splits received data buffer into individual IRC commands.
- * @param buffer The accumulated data buffer from client
- * @return std::vector<std::string> Vector of complete IRC command strings
- *
- * @details Handles IRC protocol message framing:
- * - Searches for IRC line terminators ("\\r\\n")
- * - Extracts complete commands from accumulated buffer
- * - Normalizes each command by removing extra whitespace
- * - Handles partial messages that span multiple recv() calls
- * - Returns only complete, properly terminated commands
- *
- * @note IRC protocol requires commands to end with \\r\\n (CRLF)
- * @note Incomplete commands remain in client buffer for next processing
- * @see normalize_param() for command string cleanup
+ * @brief Creates an empty channel and adds it to the channel directory.
+ * @param name Name of the channel, the caller checked it does not exist yet
+ * @return Channel* The new channel, its address stays valid until RemoveChannel()
  */
-std::vector<std::string> Server::split_receivedBuffer(std::string buffer)
+Channel *Server::addChannel(const std::string &name)
 {
-	std::vector<std::string> commands;
-	std::string line;
-	size_t start = 0;
-	size_t end;
-
-	//Search while there is "\r\n"
-	while ((end = buffer.find("\r\n", start)) != std::string::npos)
-	{
-		line = normalize_param(buffer.substr(start, end - start), false);
-		if (!line.empty())
-			commands.push_back(line);
-		start = end + 2; //skip "\r\n"
-	}
+	Channel *channel = new Channel();
+	channel->set_server(this);
+	channel->set_name(name);
+	channel->set_channelCreationTime();
+	_channels[name] = channel;
+	return channel;
+}
 
-	start = 0;
-	while ((end = buffer.find("\n", start)) != std::string::npos)
+/**
+ * @brief Replaces the channels of this server by copies of another server's channels.
+ * @param copy The server to copy the channels from
+ * @return void
+ * @note Used by the copy constructor and the copy assignment operator, channels are owned by one server
+ */
+void Server::copyChannels(Server const &copy)
+{
+	for (ChannelMap::iterator it = _channels.begin(); it != _channels.end(); ++it)
+		delete it->second;
+	_channels.clear();
+	for (ChannelMap::const_iterator it = copy._channels.begin(); it != copy._channels.end(); ++it)
 	{
-		// Skip if this \n is part of \r\n (already processed above)
-		if (end > 0 && buffer[end-1] == '\r') {
-			start = end + 1;
-			continue;
-		}
-		line = normalize_param(buffer.substr(start, end - start), false);
-		if (!line.empty())
-			commands.push_back(line);
-		start = end + 1; //skip "\n"
+		Channel *channel = new Channel(*it->second);
+		channel->set_server(this);
+		_channels[it->first] = channel;
 	}
-	return commands;
 }
 
-void Server::addChannel(Channel newChannel){this->_channels.push_back(newChannel);}
-
 
 /*****************/
 /*    Getters    */
 /*****************/
+/**
+ * @brief Finds the client of a socket.
+ * @param fd The file descriptor of the client
+ * @return Client* The client, or NULL if fd is not a client socket
+ * @note O(1): fds are small dense integers, so _clientSlots is indexed by the fd itself
+ * @note The pointer stays valid until this client is removed (see ClientSlab)
+ */
 Client* Server::get_client(int fd)
 {
-	for (size_t i = 0; i < _clients.size(); i++)
-	{
-		if (_clients[i].get_fd() == fd) {
-			return &_clients[i];
-		}
-	}
-	return NULL;
+	if (fd < 0 || static_cast<size_t>(fd) >= _clientSlots.size())
+		return NULL;
+	return _clients.get(_clientSlots[fd]);
 }
 
+/**
+ * @brief Resolves a client handle, as stored in channel memberships.
+ * @return Client* The client, or NULL if the handle is stale (the client left)
+ */
+Client* Server::get_clientByHandle(ClientHandle handle) {return _clients.get(handle);}
+
+/**
+ * @brief Finds a client by nickname, under the RFC 1459 case mapping ("Bob" finds "bob").
+ * @param nickname The nickname to look up
+ * @return Client* The client, or NULL if no client uses that nick
+ * @note O(1) through the _nicks registry
+ */
 Client *Server::get_clientNick(std::string nickname)
 {
-	for (size_t i = 0; i < this->_clients.size(); i++)
-	{
-		if (this->_clients[i].get_nickname() == nickname)
-			return &this->_clients[i];
-	}
-	return NULL;
+	return get_client(_nicks.find(nickname));
 }
 
+/**
+ * @brief Finds a channel by name, under the RFC 1459 case mapping ("#Chan" finds "#chan").
+ * @param name The channel name to look up
+ * @return Channel* The channel, or NULL if it does not exist
+ * @note O(1) through the _channels directory
+ */
 Channel* Server::get_channelByName(const std::string& name)
 {
-	for (std::vector<Channel>::iterator it = _channels.begin(); it != _channels.end(); ++it)
-	{
-		if (it->get_name() == name)
-			return &(*it);
-	}
-	return NULL;
+	ChannelMap::iterator it = _channels.find(name);
+	if (it == _channels.end())
+		return NULL;
+	return it->second;
 }
+
+EventBackend Server::get_backend() const {return this->_backend;}
+OutputFormat Server::get_output() const {return this->_output;}
+bool Server::get_trace() const {return this->_trace;}
+size_t Server::get_threads() const {return this->_threads;}
+size_t Server::get_sendqLimit(ClientClass clientClass) const {return this->_sendqLimits[clientClass];}
+const ServerMetrics &Server::get_metrics() const {return this->_metrics;}
+
+/**
+ * @brief Arena of the reactor handling the current event, for the temporaries of a command.
+ * @note Everything allocated from it is reclaimed at the end of the event loop iteration
+ */
+Arena &Server::get_arena() {return this->_current->arena;}
+
+
+/*****************/
+/*    Setters    */
+/*****************/
+
+/**
+ * @brief Selects the readiness backend used by execute(). Must be called before init().
+ * @note On non-Linux systems BACKEND_EPOLL silently falls back to BACKEND_POLL.
+ */
+void Server::set_backend(EventBackend backend)
+{
+#ifdef __linux__
+	this->_backend = backend;
+#else
+	(void)backend;
+	this->_backend = BACKEND_POLL;
+#endif
+}
+
+/**
+ * @brief Selects how replies are written to the sockets, see OutputFormat. Must be called before init().
+ */
+void Server::set_output(OutputFormat output){this->_output = output;}
+
+/**
+ * @brief Enables the colored mirror of every outgoing reply on stdout, meant for debugging.
+ */
+void Server::set_trace(bool value){this->_trace = value;}
+
+/**
+ * @brief Sets the number of epoll reactors (event loop threads) started by init(). Must be called before init().
+ * @note Values are clamped to [1, MAX_REACTOR_THREADS]; more than one reactor requires BACKEND_EPOLL
+ */
+void Server::set_threads(size_t count)
+{
+	if (count < 1)
+		count = 1;
+	if (count > MAX_REACTOR_THREADS)
+		count = MAX_REACTOR_THREADS;
+	this->_threads = count;
+}
+
+/**
+ * @brief Sets the maximum number of unsent bytes a client of the given class may accumulate.
+ * @note A client that goes over its limit is disconnected with "ERROR :SendQ exceeded"
+ */
+void Server::set_sendqLimit(ClientClass clientClass, size_t bytes){this->_sendqLimits[clientClass] = bytes;}
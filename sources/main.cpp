@@ -1,8 +1,5 @@
 #include "../includes/core/Server.hpp"
 
-//Initialize the static global variable
-bool Server::_signalRecieved = false;
-
 void printBanner()
 {
     std::cout   << "███████╗███████╗██████╗ ██╗   ██╗███████╗██████╗\n"
@@ -23,11 +20,54 @@ bool portValidation(std::string port)
 
     return 0;
 }
+bool sizeValidation(std::string value)
+{
+    return (!value.empty() && value.size() <= 9
+        && value.find_first_not_of("0123456789") == std::string::npos
+        && std::atoi(value.c_str()) > 0);
+}
+
+/**
+ * @brief Applies the optional startup flags that follow [port] [password].
+ * @return bool False if an unknown flag or an invalid value was found
+ *
+ * @note --poll forces the portable poll() loop, --epoll selects the Linux epoll loop (default on Linux)
+ * @note --sendq <bytes> / --sendq-unreg <bytes> set the sendq limit of registered / unregistered clients
+ * @note --threads <n> runs n epoll reactors sharing the port through SO_REUSEPORT (epoll only)
+ * @note --wire sends replies without the color codes (for real IRC clients), --trace mirrors them, colored, on stdout
+ */
+bool parseOptions(int ac, char** av, Server &server)
+{
+    for (int i = 3; i < ac; i++)
+    {
+        std::string option(av[i]);
+        if (option == "--poll")
+            server.set_backend(BACKEND_POLL);
+        else if (option == "--epoll")
+            server.set_backend(BACKEND_EPOLL);
+        else if (option == "--wire")
+            server.set_output(OUTPUT_WIRE);
+        else if (option == "--trace")
+            server.set_trace(true);
+        else if ((option == "--sendq" || option == "--sendq-unreg") && i + 1 < ac && sizeValidation(av[i + 1]))
+        {
+            ClientClass clientClass = (option == "--sendq") ? CLASS_USER : CLASS_UNREGISTERED;
+            server.set_sendqLimit(clientClass, std::atoi(av[++i]));
+        }
+        else if (option == "--threads" && i + 1 < ac && sizeValidation(av[i + 1])
+            && std::atoi(av[i + 1]) <= MAX_REACTOR_THREADS)
+            server.set_threads(std::atoi(av[++i]));
+        else
+            return 0;
+    }
+    return 1;
+}
+
 int main (int ac, char** av)
 {
-    if(ac != 3)
+    if(ac < 3)
     {
-        std::cerr << RED << "Correct usage: ./ircserv [port] [password]" << RESET << std::endl;
+        std::cerr << RED << "Correct usage: ./ircserv [port] [password] [--poll|--epoll] [--threads n] [--sendq bytes] [--sendq-unreg bytes] [--wire] [--trace]" << RESET << std::endl;
         return 1;
     }
 
@@ -39,15 +79,19 @@ int main (int ac, char** av)
         printBanner();
 
         Server newServer(std::atoi(av[1]), std::string(av[2]));
+        if (!parseOptions(ac, av, newServer))
+            throw std::runtime_error("Error: Invalid option. Usage: ./ircserv [port] [password] [--poll|--epoll] [--threads n] [--sendq bytes] [--sendq-unreg bytes] [--wire] [--trace]");
 
         //Signals
         std::signal(SIGINT, Server::signalHandler); // Ctrl+C
         std::signal(SIGTERM, Server::signalHandler); //kill -TERM <pid>
         std::signal(SIGQUIT, SIG_IGN); // ignore Ctrl + back slash
+        std::signal(SIGPIPE, SIG_IGN); // a peer that closed its socket makes send() fail with EPIPE instead of killing the server
 
         newServer.init();
         std::cout << YELLOW << "Waiting for a client to get connected..." << RESET << std::endl;
         newServer.execute();
+        newServer.printMetrics();
     }
     catch(const std::exception& e)
     {
@@ -37,12 +37,12 @@ bool isValidNick(const std::string &nick)
 
 /**
  * @brief Handles IRC NICK command for setting or changing client nickname.
- * @param cmd The complete NICK command string from client
+ * @param msg The parsed NICK message from client
  * @param fd The file descriptor of the client sending the command
  * @return void
  *
  * @details Implements complete NICK command processing:
- * - Extracts and normalizes nickname parameter from command
+ * - Takes the nickname from the first parameter
  * - Validates nickname format using RFC 2812 rules
  * - Checks for nickname collisions with existing clients
  * - Requires client to be password-authenticated first
@@ -55,9 +55,9 @@ bool isValidNick(const std::string &nick)
  * @see isValidNick() for nickname format validation
  * @see isregistered() for checking complete registration status
  */
-void Server::NICK(std::string cmd, int fd)
+void Server::NICK(const Message &msg, int fd)
 {
-	const std::string nickname = normalize_param(cmd.substr(4), true);
+	const std::string nickname = msg.param(0);
 
 	//1. Get pointer to the client
 	Client* cli = get_client(fd);
@@ -78,15 +78,12 @@ void Server::NICK(std::string cmd, int fd)
 		return ;
 	}
 
-	//4. Check if the nickname is already in use
-	std::vector<Client>::iterator it;
-	for(it = _clients.begin(); it != _clients.end(); it++)
+	//4. Check if the nickname is already in use, case insensitively (the client itself may change its case)
+	int owner = _nicks.find(nickname);
+	if(owner >= 0 && owner != fd)
 	{
-		if(it->get_nickname() == nickname && &(*it) != cli) //&(*it) != cli --> avoids comparing the client with itself.
-		{
-			_sendResponse(ERROR_NICKNAME_IN_USE(nickname), fd);
-			return;
-		}
+		_sendResponse(ERROR_NICKNAME_IN_USE(nickname), fd);
+		return;
 	}
 
 	if(cli && cli->get_passRegistered())
@@ -99,23 +96,25 @@ void Server::NICK(std::string cmd, int fd)
 
 		//6. Propagate change to all the client's channels
 
-		std::set<int> notified_fds; //new
-
-		std::vector<Channel>::iterator It;
-		for (It = _channels.begin(); It != _channels.end(); It++)
+		unsigned long epoch = beginFanout(); //members of several of the channels hear it once
+		ReplyBuilder reply;
+		replyNickUpdate(reply, oldNickname, nickname);
+		SharedBuffer update = formatReply(reply); //serialized once, for every channel and the client itself
+		const std::vector<Channel*> &joined = cli->get_joinedChannels();
+		for (size_t i = 0; i < joined.size(); i++)
 		{
-			if (It->get_clientByFd(fd))
-				It->broadcast_messageExcept(MSG_NICK_UPDATE(oldNickname, nickname), fd, notified_fds); //notify all channel members
+			joined[i]->broadcast_messageExcept(update, fd, epoch); //notify all channel members
+			joined[i]->invalidateNames(); //its cached NAMES lines hold the old nickname
 		}
-		//clear list!!!
 
 
 		//7. Update the client's nickname
+		_nicks.rename(oldNickname, nickname, fd);
 		cli->set_nickname(nickname);
 
 		//8. Send response to the client if it is a change
 		if (!oldNickname.empty() && oldNickname != nickname)
-			_sendResponse(MSG_NICK_UPDATE(oldNickname, nickname), fd);
+			sendBuffer(update, fd);
 	}
 	else
 	{
@@ -125,6 +124,8 @@ void Server::NICK(std::string cmd, int fd)
 	if(this->isregistered(fd))
 	{
 		cli->set_logedIn(true);
-		_sendResponse(MSG_WELCOME(nickname), fd);
+		ReplyBuilder welcome;
+		replyWelcome(welcome, nickname);
+		sendReply(welcome, fd);
 	}
 }
@@ -2,12 +2,12 @@
 
 /**
  * @brief Handles IRC PASS command for client authentication.
- * @param cmd The complete PASS command string from client
+ * @param msg The parsed PASS message from client
  * @param fd The file descriptor of the client sending the command
  * @return void
  *
  * @details Implements IRC password authentication process:
- * - Extracts and normalizes password parameter from command
+ * - Takes the password from the first parameter
  * - Validates that password parameter is provided
  * - Prevents re-authentication if client already registered
  * - Compares provided password with server password
@@ -20,13 +20,13 @@
  * @see Server::NICK() for next step in registration sequence
  * @see Server::USER() for final step in registration sequence
  */
-void Server::PASS(std::string cmd, int fd)
+void Server::PASS(const Message &msg, int fd)
 {
 	Client* cli = get_client(fd);
 	if(!cli)
 		return;
 
-	std::string pass = normalize_param(cmd.substr(4), 1);
+	std::string pass = msg.param(0);
 	if(pass.empty())
 	{
 		_sendResponse(ERROR_INSUFFICIENT_PARAMS(std::string("*")), fd);
@@ -3,13 +3,13 @@
 
 /**
  * @brief Handles IRC USER command for completing client registration.
- * @param cmd The complete USER command string from client
+ * @param msg The parsed USER message from client
  * @param fd The file descriptor of the client sending the command
  * @return void
  *
  * @details Implements the final step of IRC client registration:
  * - Parses USER command parameters (username, hostname, servername, realname)
- * - Validates minimum required parameter count (5 tokens including command)
+ * - Validates minimum required parameter count (4 parameters)
  * - Requires prior password authentication via PASS command
  * - Prevents re-registration of already registered clients
  * - Sets client username from first parameter
@@ -23,16 +23,14 @@
  * @see Server::NICK() for nickname registration step
  * @see isregistered() for checking complete registration status
  */
-void Server::USER(std::string cmd, int fd)
+void Server::USER(const Message &msg, int fd)
 {
 	Client* cli = get_client(fd);
 	if(!cli)
 		return;
 
-	std::vector<std::string> commands = split_cmd(cmd);
-
 	//1. Check number of parameters
-	if(commands.size() < 5)
+	if(msg.paramCount() < 4)
 	{
 		if(!cli->get_nickname().empty())
 			_sendResponse(ERROR_INSUFFICIENT_PARAMS(cli->get_nickname()), fd);
@@ -63,7 +61,7 @@ void Server::USER(std::string cmd, int fd)
 
 	//4. Set username
 	if(cli && cli->get_passRegistered())
-		cli->set_username(commands[1]);
+		cli->set_username(msg.param(0));
 
 	//5. Mark as logged_in if now meeting the requirements
 	if(this->isregistered(fd))
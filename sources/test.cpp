@@ -3,7 +3,14 @@
 #include <vector>
 #include <string>
 #include <sstream>
+#include <cstring>
+#include <csignal>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
 //#include "../includes/Server.hpp"
+#include "../includes/core/Server.hpp"
 
 void print(std::vector<std::string> commands)
 {
@@ -154,6 +161,330 @@ void print(std::vector<std::string> commands)
 //     std::cout << GREEN << "Command accumulation test passed!\n" << RESET;
 // }
 
+// LineFramer: simulates recv() writing into the framer, then reads the lines back
+void feed(LineFramer &framer, const std::string &bytes)
+{
+    size_t available;
+    char *space = framer.writeSpace(bytes.size(), available);
+    assert(available >= bytes.size());
+    memcpy(space, bytes.data(), bytes.size());
+    framer.commit(bytes.size());
+}
+
+LineFramer::Status nextLine(LineFramer &framer, std::string &out)
+{
+    const char *line;
+    size_t length;
+    LineFramer::Status status = framer.next(line, length);
+    out = (status == LineFramer::LINE_COMPLETE) ? std::string(line, length) : std::string();
+    return status;
+}
+
+void test_line_framer()
+{
+    LineFramer framer;
+    std::string line;
+
+    //******** CRLF lines, several in one read *******
+    feed(framer, "NICK user\r\nUSER user 0 * :Real Name\r\n");
+    assert(nextLine(framer, line) == LineFramer::LINE_COMPLETE && line == "NICK user");
+    assert(nextLine(framer, line) == LineFramer::LINE_COMPLETE && line == "USER user 0 * :Real Name");
+    assert(nextLine(framer, line) == LineFramer::LINE_NONE);
+
+    //******** Bare LF, and CRLF split between two reads *******
+    feed(framer, "PING :a\nPONG :b\r");
+    assert(nextLine(framer, line) == LineFramer::LINE_COMPLETE && line == "PING :a");
+    assert(nextLine(framer, line) == LineFramer::LINE_NONE);
+    feed(framer, "\n");
+    assert(nextLine(framer, line) == LineFramer::LINE_COMPLETE && line == "PONG :b");
+
+    //******** Line split in several reads stays buffered until its terminator *******
+    feed(framer, "PRIVMSG #a :hel");
+    assert(nextLine(framer, line) == LineFramer::LINE_NONE);
+    feed(framer, "lo ");
+    feed(framer, "world\r\n");
+    assert(nextLine(framer, line) == LineFramer::LINE_COMPLETE && line == "PRIVMSG #a :hello world");
+    assert(framer.buffered() == 0);
+
+    //******** 512 bytes terminator included is the limit *******
+    std::string longest(IRC_LINE_MAX - 2, 'x');
+    feed(framer, longest + "\r\n");
+    assert(nextLine(framer, line) == LineFramer::LINE_COMPLETE && line == longest);
+    feed(framer, longest + "x\r\n");
+    assert(nextLine(framer, line) == LineFramer::LINE_TOO_LONG);
+    assert(nextLine(framer, line) == LineFramer::LINE_NONE);
+
+    //******** Overlong line without terminator: reported once, dropped, then the next line is parsed (417 recovery) *******
+    feed(framer, std::string(IRC_LINE_MAX + 100, 'y'));
+    assert(nextLine(framer, line) == LineFramer::LINE_TOO_LONG);
+    assert(framer.buffered() == 0);
+    feed(framer, std::string(4000, 'y'));
+    assert(nextLine(framer, line) == LineFramer::LINE_NONE);
+    assert(framer.buffered() == 0);
+    feed(framer, "yyy\r\nNICK after\r\n");
+    assert(nextLine(framer, line) == LineFramer::LINE_COMPLETE && line == "NICK after");
+    assert(nextLine(framer, line) == LineFramer::LINE_NONE);
+
+    std::cout << GREEN << "LineFramer test passed!\n" << RESET;
+}
+
+// Client invitations follow the channel directory's RFC 1459 case mapping
+void test_channel_invitation()
+{
+    Client client;
+    std::string typed = "#chan";
+    std::string upper = "#CHAN";
+    std::string other = "#chan2";
+    std::string scandinavian = "#A[B]";
+    std::string scandinavianLower = "#a{b}";
+
+    client.addChannelInvitation("#Chan");
+    assert(client.get_channelInvitation(typed));
+    assert(client.get_channelInvitation(upper));
+    assert(!client.get_channelInvitation(other));
+    client.removeChannelInvitation(upper);
+    assert(!client.get_channelInvitation(typed));
+
+    client.addChannelInvitation(scandinavian);
+    assert(client.get_channelInvitation(scandinavianLower));
+
+    std::cout << GREEN << "Channel invitation test passed!\n" << RESET;
+}
+
+// Loopback helpers: run ./ircserv (make test builds it first) and talk to it like a client
+#define TEST_PORT 6790
+#define TEST_PASSWORD "testpw"
+
+bool serverListening()
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(TEST_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bool up = connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+    close(fd);
+    return up;
+}
+
+pid_t startServer(const std::vector<std::string> &options)
+{
+    assert(!serverListening()); //a server left over by an aborted run would answer instead
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0)
+    {
+        int devnull = open("/dev/null", O_WRONLY);
+        dup2(devnull, STDOUT_FILENO);
+        dup2(devnull, STDERR_FILENO);
+        std::ostringstream port;
+        port << TEST_PORT;
+        std::vector<std::string> args;
+        args.push_back("./ircserv");
+        args.push_back(port.str());
+        args.push_back(TEST_PASSWORD);
+        args.push_back("--wire");
+        args.insert(args.end(), options.begin(), options.end());
+        std::vector<char *> argv;
+        for (size_t i = 0; i < args.size(); i++)
+            argv.push_back(const_cast<char *>(args[i].c_str()));
+        argv.push_back(NULL);
+        execv(argv[0], &argv[0]);
+        _exit(127);
+    }
+    for (int i = 0; i < 100; i++) //wait until it listens
+    {
+        if (serverListening())
+            return pid;
+        usleep(20000);
+    }
+    assert(!"ircserv did not start");
+    return pid;
+}
+
+void stopServer(pid_t pid)
+{
+    kill(pid, SIGINT);
+    waitpid(pid, NULL, 0);
+}
+
+void sendLine(int fd, const std::string &line)
+{
+    std::string data = line + "\r\n";
+    assert(send(fd, data.data(), data.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(data.size()));
+}
+
+// Everything the server sends until it stays quiet for 200 ms
+std::string readReplies(int fd)
+{
+    std::string replies;
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    while (poll(&pfd, 1, 200) > 0)
+    {
+        char buffer[4096];
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+            break;
+        replies.append(buffer, received);
+    }
+    return replies;
+}
+
+int connectClient(const std::string &nick)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(TEST_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    assert(connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    sendLine(fd, "PASS " TEST_PASSWORD);
+    sendLine(fd, "NICK " + nick);
+    sendLine(fd, "USER " + nick + " 0 * :" + nick);
+    assert(readReplies(fd).find(" 001 " + nick) != std::string::npos);
+    return fd;
+}
+
+size_t countOf(const std::string &text, const std::string &token)
+{
+    size_t count = 0;
+    for (size_t pos = text.find(token); pos != std::string::npos; pos = text.find(token, pos + token.size()))
+        count++;
+    return count;
+}
+
+// A member sharing several channels with the sender hears its NICK and QUIT once
+void test_multi_channel_fanout(const std::vector<std::string> &options)
+{
+    pid_t server = startServer(options);
+    int alice = connectClient("alice");
+    int bob = connectClient("bob");
+    sendLine(alice, "JOIN #one,#two,#three");
+    readReplies(alice);
+    sendLine(bob, "JOIN #one,#two,#three");
+    readReplies(bob);
+    readReplies(alice);
+
+    sendLine(bob, "NICK robert");
+    std::string replies = readReplies(alice);
+    assert(countOf(replies, " NICK ") == 1);
+    assert(replies.find(":bob NICK robert") != std::string::npos);
+
+    sendLine(bob, "QUIT :bye");
+    replies = readReplies(alice);
+    assert(countOf(replies, " QUIT ") == 1);
+    assert(replies.find(":robert!~bob@localhost QUIT :bye") != std::string::npos);
+
+    close(alice);
+    close(bob);
+    stopServer(server);
+}
+
+// Lines sent right before the peer closes the connection still run (EOF is "parse, then close")
+void test_lines_before_close(const std::vector<std::string> &options)
+{
+    pid_t server = startServer(options);
+    int alice = connectClient("alice");
+    sendLine(alice, "JOIN #eof");
+    readReplies(alice);
+
+    int bob = connectClient("bob");
+    std::string last = "JOIN #eof\r\nPRIVMSG #eof :last words\r\n";
+    assert(send(bob, last.data(), last.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(last.size()));
+    close(bob);
+    std::string replies = readReplies(alice);
+    assert(replies.find(" JOIN #eof") != std::string::npos);
+    assert(replies.find(":bob!~bob@localhost PRIVMSG #eof :last words") != std::string::npos);
+
+    close(alice);
+    stopServer(server);
+}
+
+// The cached prefixes follow every NICK, before and after USER
+void test_client_prefixes()
+{
+    Client client;
+    client.set_nickname("first");
+    assert(client.get_hostname() == "first!");
+    assert(client.get_source() == "first!~@localhost");
+    client.set_nickname("second"); //NICK again before USER
+    assert(client.get_source() == "second!~@localhost");
+    client.set_username("user");
+    assert(client.get_hostname() == "second!user");
+    assert(client.get_source() == "second!~user@localhost");
+    client.set_nickname("third");
+    assert(client.get_hostname() == "third!user");
+    assert(client.get_source() == "third!~user@localhost");
+
+    Client copy(client);
+    assert(copy.get_source() == "third!~user@localhost");
+    copy.set_nickname("fourth");
+    assert(copy.get_source() == "fourth!~user@localhost");
+    assert(client.get_source() == "third!~user@localhost");
+
+    //Same through the server: NICK twice before USER, then once more after it
+    pid_t server = startServer(std::vector<std::string>());
+    int alice = connectClient("alice");
+    sendLine(alice, "JOIN #p");
+    readReplies(alice);
+    int other = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(TEST_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    assert(connect(other, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    sendLine(other, "PASS " TEST_PASSWORD);
+    sendLine(other, "NICK first");
+    sendLine(other, "NICK second");
+    sendLine(other, "USER user 0 * :User");
+    sendLine(other, "JOIN #p");
+    readReplies(other);
+    readReplies(alice);
+    sendLine(other, "PRIVMSG #p :one");
+    assert(readReplies(alice).find(":second!~user@localhost PRIVMSG #p :one") != std::string::npos);
+    sendLine(other, "NICK third");
+    readReplies(other);
+    readReplies(alice);
+    sendLine(other, "PRIVMSG #p :two");
+    assert(readReplies(alice).find(":third!~user@localhost PRIVMSG #p :two") != std::string::npos);
+
+    close(alice);
+    close(other);
+    stopServer(server);
+    std::cout << GREEN << "Client prefixes test passed!\n" << RESET;
+}
+
+// MODE checks operator privileges before it looks at unknown letters
+void test_mode_privileges()
+{
+    pid_t server = startServer(std::vector<std::string>());
+    int op = connectClient("op");
+    int member = connectClient("member");
+    sendLine(op, "JOIN #m");
+    readReplies(op);
+    sendLine(member, "JOIN #m");
+    readReplies(member);
+    readReplies(op);
+
+    sendLine(member, "MODE #m +z");
+    std::string replies = readReplies(member);
+    assert(replies.find(" 482 ") != std::string::npos && replies.find(" 472 ") == std::string::npos);
+    sendLine(member, "MODE #m +i");
+    assert(readReplies(member).find(" 482 ") != std::string::npos);
+    sendLine(op, "MODE #m +z");
+    replies = readReplies(op);
+    assert(replies.find(" 472 ") != std::string::npos && replies.find(" 482 ") == std::string::npos);
+
+    close(op);
+    close(member);
+    stopServer(server);
+    std::cout << GREEN << "MODE privileges test passed!\n" << RESET;
+}
 
 std::vector<std::string> split_cmdo(std::string cmd)
 {
@@ -182,7 +513,28 @@ int main()
     //test_client_buffer();
     std::vector<std::string> commands = split_cmdo("USER daniela 0 * :Daniela Torretta");
     print(commands);
+    test_line_framer();
+    test_channel_invitation();
+    std::vector<std::string> options;
+    test_multi_channel_fanout(options); //epoll, one reactor
+    options.push_back("--poll");
+    test_multi_channel_fanout(options);
+    options[0] = "--threads";
+    options.push_back("3");
+    test_multi_channel_fanout(options); //alice and bob may be owned by different reactors
+    std::cout << GREEN << "Multi-channel fanout test passed!\n" << RESET;
+    options.clear();
+    test_lines_before_close(options);
+    options.push_back("--poll");
+    test_lines_before_close(options);
+    options[0] = "--threads";
+    options.push_back("3");
+    test_lines_before_close(options);
+    std::cout << GREEN << "Lines before close test passed!\n" << RESET;
+    test_client_prefixes();
+    test_mode_privileges();
     return 0;
 }
 
+//make test (builds this file with every server object but main.o, then runs it)
 //g++ -std=c++98 -Wall -Wextra -Iincludes sources/Server.cpp sources/Client.cpp sources/test.cpp -o test_split
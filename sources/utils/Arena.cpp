@@ -0,0 +1,59 @@
+#include "../../includes/utils/Arena.hpp"
+
+Arena::Arena() : _current(0), _used(0), _reserved(0) {}
+
+Arena::~Arena()
+{
+	for (size_t i = 0; i < _chunks.size(); i++)
+		::operator delete(_chunks[i].data);
+}
+
+
+/*****************/
+/*    Getters    */
+/*****************/
+size_t Arena::get_reserved() const {return _reserved;}
+
+
+/******************/
+/*      Utils     */
+/******************/
+
+/**
+ * @brief Hands out bytes that stay valid until the next reset().
+ * @param bytes Number of bytes wanted
+ * @return void* Memory aligned on ARENA_ALIGN
+ * @note Only allocates a new chunk when every chunk kept from earlier iterations is full
+ */
+void *Arena::allocate(size_t bytes)
+{
+	bytes = (bytes + ARENA_ALIGN - 1) & ~static_cast<size_t>(ARENA_ALIGN - 1);
+	while (_current < _chunks.size())
+	{
+		if (_used + bytes <= _chunks[_current].size)
+		{
+			void *place = _chunks[_current].data + _used;
+			_used += bytes;
+			return place;
+		}
+		_current++;
+		_used = 0;
+	}
+	Chunk chunk;
+	chunk.size = bytes > ARENA_CHUNK_SIZE ? bytes : ARENA_CHUNK_SIZE;
+	chunk.data = static_cast<char *>(::operator new(chunk.size));
+	_chunks.push_back(chunk);
+	_reserved += chunk.size;
+	_used = bytes;
+	return chunk.data;
+}
+
+/**
+ * @brief Reclaims every allocation at once, at the end of an event loop iteration.
+ * @warning Containers backed by the arena must not outlive the call
+ */
+void Arena::reset()
+{
+	_current = 0;
+	_used = 0;
+}
@@ -0,0 +1,65 @@
+#include "../../includes/utils/CaseMapping.hpp"
+
+/**
+ * @brief Builds the RFC 1459 lowercase table: A-Z and "[]\~" map to a-z and "{}|^".
+ */
+static const unsigned char *buildFoldTable()
+{
+	static unsigned char table[256];
+	for (int c = 0; c < 256; c++)
+		table[c] = static_cast<unsigned char>(c);
+	for (int c = 'A'; c <= 'Z'; c++)
+		table[c] = static_cast<unsigned char>(c + ('a' - 'A'));
+	table['['] = '{';
+	table[']'] = '}';
+	table['\\'] = '|';
+	table['~'] = '^';
+	return table;
+}
+
+//filled during static initialization, before main() starts any reactor thread
+static const unsigned char *g_foldTable = buildFoldTable();
+
+unsigned char ircFoldChar(unsigned char c) {return g_foldTable[c];}
+
+/**
+ * @brief Returns the RFC 1459 lowercase form of a nickname or channel name.
+ */
+std::string ircCasefold(const std::string &name)
+{
+	std::string folded(name);
+	for (size_t i = 0; i < folded.size(); i++)
+		folded[i] = g_foldTable[static_cast<unsigned char>(folded[i])];
+	return folded;
+}
+
+/**
+ * @brief Compares two names under the RFC 1459 case mapping.
+ */
+bool ircCaseEqual(const std::string &a, const std::string &b)
+{
+	if (a.size() != b.size())
+		return false;
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		if (g_foldTable[static_cast<unsigned char>(a[i])] != g_foldTable[static_cast<unsigned char>(b[i])])
+			return false;
+	}
+	return true;
+}
+
+/**
+ * @brief FNV-1a over the folded bytes.
+ */
+size_t IrcCaseHash::operator()(const std::string &name) const
+{
+	size_t hash = 2166136261u;
+	for (size_t i = 0; i < name.size(); i++)
+	{
+		hash ^= g_foldTable[static_cast<unsigned char>(name[i])];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+bool IrcCaseEqual::operator()(const std::string &a, const std::string &b) const {return ircCaseEqual(a, b);}
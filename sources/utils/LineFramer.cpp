@@ -0,0 +1,115 @@
+#include "../../includes/utils/LineFramer.hpp"
+#include <algorithm>
+#include <cstring>
+
+LineFramer::LineFramer(size_t maxLine) : _start(0), _scan(0), _end(0), _maxLine(maxLine), _discarding(false) {}
+
+LineFramer::LineFramer(LineFramer const &copy)
+	: _buffer(copy._buffer), _start(copy._start), _scan(copy._scan), _end(copy._end),
+	_maxLine(copy._maxLine), _discarding(copy._discarding) {}
+
+LineFramer& LineFramer::operator=(LineFramer const &copy)
+{
+	if (this != &copy)
+	{
+		this->_buffer = copy._buffer;
+		this->_start = copy._start;
+		this->_scan = copy._scan;
+		this->_end = copy._end;
+		this->_maxLine = copy._maxLine;
+		this->_discarding = copy._discarding;
+	}
+	return (*this);
+}
+
+LineFramer::~LineFramer(){}
+
+
+/*****************/
+/*    Getters    */
+/*****************/
+size_t LineFramer::buffered() const {return _end - _start;}
+
+
+/******************/
+/*      Utils     */
+/******************/
+
+/**
+ * @brief Returns where the next recv() must write, with at least `minimum` free bytes.
+ * @param minimum Free bytes wanted after the received data
+ * @param available Set to the free bytes actually available at the returned address
+ * @return char* First free byte of the storage
+ * @note Invalidates the views returned by next()
+ */
+char *LineFramer::writeSpace(size_t minimum, size_t &available)
+{
+	if (_start == _end)
+	{
+		_start = 0;
+		_scan = 0;
+		_end = 0;
+	}
+	else if (_start > 0 && _buffer.size() - _end < minimum)
+	{
+		memmove(&_buffer[0], &_buffer[_start], _end - _start);
+		_scan -= _start;
+		_end -= _start;
+		_start = 0;
+	}
+	if (_buffer.size() - _end < minimum)
+		_buffer.resize(std::max(_buffer.size() * 2, _end + minimum));
+	available = _buffer.size() - _end;
+	return &_buffer[_end];
+}
+
+/**
+ * @brief Accounts bytes written at the address returned by writeSpace().
+ * @param bytes Number of bytes received
+ */
+void LineFramer::commit(size_t bytes){_end += bytes;}
+
+/**
+ * @brief Hands out the next complete line, without copying it.
+ * @param line Set to the first byte of the line (LINE_COMPLETE only)
+ * @param length Set to the line length, without its terminator (LINE_COMPLETE only)
+ * @return Status LINE_COMPLETE, LINE_TOO_LONG once per overlong line, or LINE_NONE when more bytes are needed
+ */
+LineFramer::Status LineFramer::next(const char *&line, size_t &length)
+{
+	while (_scan < _end)
+	{
+		const char *newline = static_cast<const char *>(memchr(&_buffer[_scan], '\n', _end - _scan));
+		if (!newline)
+		{
+			_scan = _end;
+			if (_discarding)
+				_start = _end; //still inside the overlong line: drop what arrived
+			else if (_end - _start >= _maxLine)
+			{
+				_discarding = true;
+				_start = _end;
+				return LINE_TOO_LONG;
+			}
+			return LINE_NONE;
+		}
+
+		size_t lineStart = _start;
+		size_t lineSize = (newline - &_buffer[0]) + 1 - lineStart; //terminator included
+		bool dropped = _discarding;
+		_start = lineStart + lineSize;
+		_scan = _start;
+		_discarding = false;
+		if (dropped)
+			continue; //tail of a line already reported as too long
+		if (lineSize > _maxLine)
+			return LINE_TOO_LONG;
+
+		line = &_buffer[lineStart];
+		length = lineSize - 1;
+		if (length > 0 && line[length - 1] == '\r')
+			length--;
+		return LINE_COMPLETE;
+	}
+	return LINE_NONE;
+}
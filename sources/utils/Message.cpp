@@ -0,0 +1,188 @@
+#include "../../includes/utils/Message.hpp"
+
+Message::Message() : _line(NULL), _length(0), _paramCount(0), _hasTrailing(false)
+{
+	_prefix.offset = 0;
+	_prefix.length = 0;
+	_command.offset = 0;
+	_command.length = 0;
+}
+
+Message::Message(Message const &copy)
+{
+	*this = copy;
+}
+
+Message& Message::operator=(Message const &copy)
+{
+	if (this != &copy)
+	{
+		this->_line = copy._line;
+		this->_length = copy._length;
+		this->_prefix = copy._prefix;
+		this->_command = copy._command;
+		for (size_t i = 0; i < copy._paramCount; i++)
+			this->_params[i] = copy._params[i];
+		this->_paramCount = copy._paramCount;
+		this->_hasTrailing = copy._hasTrailing;
+	}
+	return (*this);
+}
+
+Message::~Message(){}
+
+/**
+ * @brief Splits a line (without its "\r\n" terminator) into prefix, command and parameters.
+ * @param line First byte of the line
+ * @param length Length of the line
+ * @return bool False if the line has no command (empty, only spaces or only a prefix)
+ */
+bool Message::parse(const char *line, size_t length)
+{
+	_line = line;
+	_length = length;
+	_prefix.offset = 0;
+	_prefix.length = 0;
+	_command.length = 0;
+	_paramCount = 0;
+	_hasTrailing = false;
+
+	size_t i = 0;
+	while (i < length && line[i] == ' ')
+		i++;
+
+	//1. Optional ":prefix"
+	if (i < length && line[i] == ':')
+	{
+		_prefix.offset = ++i;
+		while (i < length && line[i] != ' ')
+			i++;
+		_prefix.length = i - _prefix.offset;
+		while (i < length && line[i] == ' ')
+			i++;
+	}
+
+	//2. Command
+	_command.offset = i;
+	while (i < length && line[i] != ' ')
+		i++;
+	_command.length = i - _command.offset;
+	if (_command.length == 0)
+		return false;
+
+	//3. Parameters
+	while (i < length)
+	{
+		while (i < length && line[i] == ' ')
+			i++;
+		if (i == length)
+			break;
+		Span &param = _params[_paramCount++];
+		if (line[i] == ':' || _paramCount == MESSAGE_MAX_PARAMS)
+		{
+			if (line[i] == ':')
+			{
+				_hasTrailing = true;
+				i++;
+			}
+			param.offset = i;
+			param.length = length - i;
+			break;
+		}
+		param.offset = i;
+		while (i < length && line[i] != ' ')
+			i++;
+		param.length = i - param.offset;
+	}
+	return true;
+}
+
+/**
+ * @brief Caps the number of parameters, the last one kept then runs until the end of the line.
+ * @param max Most parameters the command takes (1 to MESSAGE_MAX_PARAMS)
+ * @return void
+ * @note Same as the parameter limit of the classic ircd message table: with max 2,
+ * "PRIVMSG bob hi there" gives "hi there" as second parameter instead of dropping "there"
+ */
+void Message::limitParams(size_t max)
+{
+	if (max == 0 || _paramCount <= max)
+		return;
+	Span &last = _params[max - 1];
+	last.length = _length - last.offset;
+	_paramCount = max;
+	_hasTrailing = false; //the trailing parameter, if any, was merged verbatim (':' included)
+}
+
+
+/*****************/
+/*    Getters    */
+/*****************/
+std::string Message::prefix() const {return std::string(_line + _prefix.offset, _prefix.length);}
+std::string Message::command() const {return std::string(_line + _command.offset, _command.length);}
+size_t Message::commandLength() const {return _command.length;}
+const char *Message::commandData() const {return _line + _command.offset;}
+size_t Message::paramCount() const {return _paramCount;}
+bool Message::hasTrailing() const {return _hasTrailing;}
+const char *Message::paramData(size_t index) const {return _line + _params[index].offset;}
+size_t Message::paramLength(size_t index) const {return _params[index].length;}
+
+/**
+ * @brief Copies out one parameter.
+ * @param index Parameter index, starting at 0 (right after the command)
+ * @return std::string The parameter, empty if it does not exist
+ */
+std::string Message::param(size_t index) const
+{
+	if (index >= _paramCount)
+		return std::string();
+	return std::string(_line + _params[index].offset, _params[index].length);
+}
+
+/**
+ * @brief Copies out one parameter into an arena, for a temporary of the current command.
+ */
+ArenaString Message::param(size_t index, Arena &arena) const
+{
+	if (index >= _paramCount)
+		return ArenaString(ArenaAllocator<char>(arena));
+	return ArenaString(_line + _params[index].offset, _params[index].length, ArenaAllocator<char>(arena));
+}
+
+/**
+ * @brief Copies out one parameter, or returns a default when it is missing or empty.
+ */
+std::string Message::paramOr(size_t index, const std::string &fallback) const
+{
+	if (index >= _paramCount || _params[index].length == 0)
+		return fallback;
+	return param(index);
+}
+
+/**
+ * @brief Splits a comma separated parameter ("#a,#b,#c") into its items.
+ * @param index Parameter index
+ * @param arena Arena of the current event loop iteration, which holds the list and its items
+ * @return ArenaStringList The items; empty items are kept, except a trailing one
+ * @note Same items as the std::getline(stream, item, ',') loops it replaces
+ */
+ArenaStringList Message::paramList(size_t index, Arena &arena) const
+{
+	ArenaStringList items = ArenaStringList(ArenaAllocator<ArenaString>(arena));
+	if (index >= _paramCount)
+		return items;
+
+	const char *data = _line + _params[index].offset;
+	size_t length = _params[index].length;
+	size_t start = 0;
+	for (size_t i = 0; i <= length; i++)
+	{
+		if (i == length || data[i] == ',')
+		{
+			if (i < length || i > start)
+				items.push_back(ArenaString(data + start, i - start, ArenaAllocator<char>(arena)));
+			start = i + 1;
+		}
+	}
+	return items;
+}
@@ -0,0 +1,56 @@
+#include "../../includes/utils/NickRegistry.hpp"
+
+NickRegistry::NickRegistry() {}
+
+NickRegistry::NickRegistry(NickRegistry const &copy) : _nicks(copy._nicks) {}
+
+NickRegistry& NickRegistry::operator=(NickRegistry const &copy)
+{
+	if (this != &copy)
+		this->_nicks = copy._nicks;
+	return (*this);
+}
+
+NickRegistry::~NickRegistry() {}
+
+/**
+ * @brief Finds the client using a nickname, whatever its case.
+ * @param nick The nickname to look up
+ * @return int The client fd, -1 if the nick is free
+ */
+int NickRegistry::find(const std::string &nick) const
+{
+	Map::const_iterator it = _nicks.find(nick);
+	if (it == _nicks.end())
+		return -1;
+	return it->second;
+}
+
+/**
+ * @brief Moves a client from its old nickname to a new one.
+ * @param oldNick Current nickname of the client, empty if it had none
+ * @param newNick New nickname, the caller checked it is free (or only differs in case)
+ * @param fd The client fd
+ * @return void
+ */
+void NickRegistry::rename(const std::string &oldNick, const std::string &newNick, int fd)
+{
+	if (!oldNick.empty())
+		remove(oldNick, fd);
+	_nicks[newNick] = fd;
+}
+
+/**
+ * @brief Frees a nickname, if it belongs to the given client.
+ * @param nick The nickname to free
+ * @param fd The client fd
+ * @return void
+ */
+void NickRegistry::remove(const std::string &nick, int fd)
+{
+	Map::iterator it = _nicks.find(nick);
+	if (it != _nicks.end() && it->second == fd)
+		_nicks.erase(it);
+}
+
+size_t NickRegistry::size() const {return _nicks.size();}
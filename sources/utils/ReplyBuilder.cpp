@@ -0,0 +1,155 @@
+#include "../../includes/utils/ReplyBuilder.hpp"
+#include "../../includes/utils/messages.hpp"
+#include <cstring>
+
+ReplyBuilder::ReplyBuilder() : _length(0) {}
+
+ReplyBuilder::ReplyBuilder(ReplyBuilder const &copy) : _length(0)
+{
+	append(copy.data(), copy.size());
+}
+
+ReplyBuilder& ReplyBuilder::operator=(ReplyBuilder const &copy)
+{
+	if (this != &copy)
+	{
+		this->_length = 0;
+		this->_spill.clear();
+		append(copy.data(), copy.size());
+	}
+	return (*this);
+}
+
+ReplyBuilder::~ReplyBuilder(){}
+
+
+/*****************/
+/*    Getters    */
+/*****************/
+const char *ReplyBuilder::data() const {return _spill.empty() ? _inline : _spill.data();}
+size_t ReplyBuilder::size() const {return _length;}
+
+
+/******************/
+/*      Utils     */
+/******************/
+
+/**
+ * @brief Appends bytes to the reply.
+ * @param bytes The bytes to copy
+ * @param length Number of bytes
+ * @return ReplyBuilder& The builder, for chaining
+ * @note The first append that does not fit in _inline moves the reply to _spill for good
+ */
+ReplyBuilder &ReplyBuilder::append(const char *bytes, size_t length)
+{
+	if (_spill.empty() && _length + length <= REPLY_INLINE_MAX)
+		std::memcpy(_inline + _length, bytes, length);
+	else
+	{
+		if (_spill.empty())
+			_spill.assign(_inline, _length);
+		_spill.append(bytes, length);
+	}
+	_length += length;
+	return (*this);
+}
+
+ReplyBuilder &ReplyBuilder::operator<<(const std::string &text)
+{
+	return append(text.data(), text.size());
+}
+
+ReplyBuilder &ReplyBuilder::operator<<(const ArenaString &text)
+{
+	return append(text.data(), text.size());
+}
+
+
+/******************/
+/*  Hot replies   */
+/******************/
+//Each function writes exactly what the messages.hpp macro of the same name returns
+
+void replyPrivmsgChannel(ReplyBuilder &out, const std::string &source, const std::string &target, const ArenaString &message)
+{
+	out << ":" << source << " PRIVMSG " << target << " :" << message << CRLF;
+}
+
+void replyPrivmsgUser(ReplyBuilder &out, const std::string &nickname, const std::string &user, const std::string &target, const ArenaString &message)
+{
+	out << ":" << nickname << "!~" << user << " PRIVMSG " << target << " :" << message << CRLF;
+}
+
+void replyUserJoin(ReplyBuilder &out, const std::string &hostname, const std::string &ipaddress, const std::string &channelname)
+{
+	out << ":" << hostname << "@" << ipaddress << " JOIN " << channelname << CRLF;
+}
+
+/**
+ * @note MSG_USER_PART takes the IP address too but never prints it, so it is not a parameter here
+ */
+void replyUserPart(ReplyBuilder &out, const std::string &source, const std::string &channelname, const std::string &reason)
+{
+	out << ":" << source << " PART " << channelname << " :" << reason << CRLF;
+}
+
+void replyNamesList(ReplyBuilder &out, const std::string &nickname, const std::string &channelname, const std::string &clientslist)
+{
+	out << ":ft_irc 353 " << nickname << " @ " << channelname << " :" << clientslist << CRLF;
+}
+
+void replyNamesEnd(ReplyBuilder &out, const std::string &nickname, const std::string &channelname)
+{
+	out << ":ft_irc 366 " << nickname << " " << channelname << " :End of /NAMES list" << CRLF;
+}
+
+void replyChannelTopic(ReplyBuilder &out, const std::string &nickname, const std::string &channelname, const std::string &topic)
+{
+	out << ":ft_irc 332 " << nickname << " " << channelname << " :" << topic << CRLF;
+}
+
+void replyNoSetTopic(ReplyBuilder &out, const std::string &nickname, const std::string &channelname)
+{
+	out << ":ft_irc 331 " << nickname << " " << channelname << " :No topic is set" << CRLF;
+}
+
+void replyTopicWhoTime(ReplyBuilder &out, const std::string &nickname, const std::string &channelname, const std::string &creationtime)
+{
+	out << ":ft_irc 333 " << nickname << " " << channelname << " " << nickname << " " << creationtime << CRLF;
+}
+
+void replyNickUpdate(ReplyBuilder &out, const std::string &oldnickname, const std::string &nickname)
+{
+	out << ":" << oldnickname << " NICK " << nickname << CRLF;
+}
+
+void replyQuit(ReplyBuilder &out, const std::string &source, const std::string &reason)
+{
+	out << ":" << source << " QUIT :" << reason << CRLF;
+}
+
+void replyModeChange(ReplyBuilder &out, const std::string &source, const std::string &channelname, const ArenaString &modes, const ArenaString &params)
+{
+	out << ":" << source << " MODE " << channelname << " " << modes << " " << params << CRLF;
+}
+
+void replyKickUser(ReplyBuilder &out, const std::string &source, const std::string &channelname, const std::string &target)
+{
+	out << ":" << source << " KICK " << channelname << " " << target << CRLF;
+}
+
+void replyKickUserReason(ReplyBuilder &out, const std::string &source, const std::string &channelname, const std::string &target, const std::string &reason)
+{
+	out << ":" << source << " KICK " << channelname << " " << target << " :" << reason << CRLF;
+}
+
+void replyWelcome(ReplyBuilder &out, const std::string &nickname)
+{
+	out << ":ft_irc 001 " << nickname << " :Connected to IRC network successfully!" << CRLF;
+}
+
+void replyCommandNotRecognized(ReplyBuilder &out, const std::string &nickname, const ArenaString &command)
+{
+	out << ":ft_irc 421 " << nickname << " " << command << " :Command not found" << CRLF;
+}
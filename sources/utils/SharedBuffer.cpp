@@ -0,0 +1,93 @@
+#include "../../includes/utils/SharedBuffer.hpp"
+#include <cstring>
+#include <new>
+
+SharedBuffer::Block *SharedBuffer::_pool = NULL;
+size_t SharedBuffer::_pooled = 0;
+
+SharedBuffer::SharedBuffer() : _block(NULL) {}
+
+SharedBuffer::SharedBuffer(const std::string &bytes) : _block(NULL)
+{
+	assign(bytes.data(), bytes.size());
+}
+
+SharedBuffer::SharedBuffer(const char *bytes, size_t length) : _block(NULL)
+{
+	assign(bytes, length);
+}
+
+SharedBuffer::SharedBuffer(SharedBuffer const &copy) : _block(copy._block)
+{
+	if (_block)
+		_block->refs++;
+}
+
+SharedBuffer& SharedBuffer::operator=(SharedBuffer const &copy)
+{
+	if (_block != copy._block)
+	{
+		release();
+		_block = copy._block;
+		if (_block)
+			_block->refs++;
+	}
+	return (*this);
+}
+
+SharedBuffer::~SharedBuffer(){release();}
+
+/**
+ * @brief Copies the bytes into a block of their own, taken from the free list when they fit.
+ * @note The bytes follow the Block header in the same allocation
+ */
+void SharedBuffer::assign(const char *bytes, size_t length)
+{
+	if (length == 0)
+		return;
+	if (length <= SHARED_BUFFER_POOLED_SIZE && _pool)
+	{
+		_block = _pool;
+		_pool = _pool->next;
+		_pooled--;
+	}
+	else
+	{
+		size_t capacity = length <= SHARED_BUFFER_POOLED_SIZE ? SHARED_BUFFER_POOLED_SIZE : length;
+		_block = static_cast<Block *>(::operator new(sizeof(Block) + capacity));
+		_block->capacity = capacity;
+	}
+	_block->refs = 1;
+	_block->size = length;
+	_block->next = NULL;
+	memcpy(_block + 1, bytes, length);
+}
+
+/**
+ * @brief Drops this reference; the last one returns the block to the free list, or to the heap
+ *        when it is larger than SHARED_BUFFER_POOLED_SIZE or the list is full.
+ */
+void SharedBuffer::release()
+{
+	if (_block && --_block->refs == 0)
+	{
+		if (_block->capacity == SHARED_BUFFER_POOLED_SIZE && _pooled < SHARED_BUFFER_POOL_MAX)
+		{
+			_block->next = _pool;
+			_pool = _block;
+			_pooled++;
+		}
+		else
+			::operator delete(_block);
+	}
+	_block = NULL;
+}
+
+
+/*****************/
+/*    Getters    */
+/*****************/
+const char *SharedBuffer::data() const {return _block ? reinterpret_cast<const char *>(_block + 1) : "";}
+size_t SharedBuffer::size() const {return _block ? _block->size : 0;}
+bool SharedBuffer::empty() const {return size() == 0;}
+size_t SharedBuffer::use_count() const {return _block ? _block->refs : 0;}
@@ -14,12 +14,16 @@ extern Server* g_server;
  * - Enables proper cleanup of resources before exit
  *
  * @note Static function registered with signal() system call
+ * @note Only touches a volatile sig_atomic_t: reactor threads block SIGINT/SIGTERM,
+ *       so the flag is read by the main thread alone (see runReactor())
  * @see Server::execute() for main loop that checks shutdown flag
  */
 void Server::signalHandler(int sig)
 {
 	(void) sig;
-	_signalRecieved = true;
+	int savedErrno = errno; //the handler may interrupt a syscall whose errno is about to be read
+	_signalRecieved = 1;
+	errno = savedErrno;
 }
 
 /**
@@ -40,92 +44,487 @@ bool Server::isregistered(int fd)
 }
 
 /**
- * @brief Sends a response message to a client over IRC connection.
+ * @brief Queues a response message for a client, it is sent at the end of the loop iteration.
  * @param response The response string to send to client
  * @param fd The file descriptor of the target client
  * @return void
  * @details Handles IRC message transmission:
+ * - Appends the reply to the client's bounded outbound queue
+ * - Schedules the client for the coalesced flush at the end of the loop iteration
+ * - A reply that would overflow the sendq limit of the client's class disconnects the client
+ * - Clients already flagged as quitting receive nothing else
+ * @see flushPendingClients() for the actual writev() calls
+ * @see sendqExceeded() for the slow-consumer handling
  */
 void Server::_sendResponse(std::string response, int fd)
 {
-	std::string colored = YELLOW + response + RESET;
+	sendBuffer(formatReply(response), fd);
+}
+
+/**
+ * @brief Serializes a reply once into an immutable buffer that can be queued for many clients.
+ * @param response The response string, as built by the messages.hpp macros
+ * @return SharedBuffer The bytes that go on the wire
+ * @see Channel::broadcast_message() for the fanout that shares the result
+ */
+SharedBuffer Server::formatReply(const std::string &response)
+{
+	return serializeReply(response.data(), response.size());
+}
 
-	if(send(fd, colored.c_str(), colored.size(), 0) == -1)
-		std::cerr << RED << "Response send() failed" << RESET << std::endl;
+/**
+ * @brief Same as formatReply(const std::string &), for a reply written by a ReplyBuilder.
+ */
+SharedBuffer Server::formatReply(const ReplyBuilder &reply)
+{
+	return serializeReply(reply.data(), reply.size());
 }
 
 /**
- * @brief Normalizes IRC command parameters by trimming whitespace and removing prefix colon.
- * @param s The parameter string to normalize
- * @param flag If true, removes leading ':' character from parameter
- * @return std::string The normalized parameter string
+ * @brief Copies a reply into the SharedBuffer that goes on the wire, in the configured OutputFormat.
+ * @param bytes The reply, CRLF included
+ * @param length Length of the reply
+ * @return SharedBuffer The bytes that go on the wire
  *
- * @details Performs IRC parameter cleanup:
- * - Removes leading and trailing whitespace (spaces, tabs, CRLF)
- * - Optionally removes leading ':' when flag is true
- * - Handles empty strings after whitespace removal
- * - Essential for proper IRC command parameter parsing
+ * @details
+ * - OUTPUT_WIRE: the reply is copied once, as it is
+ * - OUTPUT_COLOR: the reply is wrapped in YELLOW ... RESET, on the stack (ReplyBuilder), which costs
+ *   another copy and sizeof(YELLOW) + sizeof(RESET) - 2 bytes per recipient
+ * With --trace each reply is also printed on stdout, colored, whatever the format.
+ */
+SharedBuffer Server::serializeReply(const char *bytes, size_t length)
+{
+	if (_trace)
+		std::cout << YELLOW << std::string(bytes, length) << RESET << std::flush;
+	if (_output == OUTPUT_WIRE)
+		return SharedBuffer(bytes, length);
+
+	ReplyBuilder colored;
+	colored << YELLOW;
+	colored.append(bytes, length) << RESET;
+	return SharedBuffer(colored.data(), colored.size());
+}
+
+/**
+ * @brief Same as _sendResponse(), for a reply written by a ReplyBuilder.
+ * @param reply The reply, e.g. filled by replyNamesList()
+ * @param fd The file descriptor of the target client
+ */
+void Server::sendReply(const ReplyBuilder &reply, int fd)
+{
+	sendBuffer(formatReply(reply), fd);
+}
+
+/**
+ * @brief Queues an already serialized reply for a client by reference and schedules a flush.
+ * @param buffer The serialized reply (shared, never copied)
+ * @param fd The file descriptor of the target client
+ * @return void
+ */
+void Server::sendBuffer(const SharedBuffer &buffer, int fd)
+{
+	Client *client = get_client(fd);
+	if (!client || client->get_isQuitting())
+		return;
+
+	if (!client->enqueueResponse(buffer, _sendqLimits[client->get_class()]))
+	{
+		sendqExceeded(client);
+		return;
+	}
+	_metrics.repliesQueued++;
+	_metrics.bytesQueued += buffer.size();
+	if (_output == OUTPUT_COLOR)
+		_metrics.colorBytes += sizeof(YELLOW) - 1 + sizeof(RESET) - 1;
+	scheduleFlush(client);
+}
+
+/**
+ * @brief Accounts one channel broadcast in ServerMetrics.
+ * @param buffer The buffer serialized for the broadcast
+ * @param recipients Number of clients it was queued for
+ */
+void Server::recordFanout(const SharedBuffer &buffer, size_t recipients)
+{
+	_metrics.fanouts++;
+	_metrics.fanoutRecipients += recipients;
+	_metrics.fanoutBytesSerialized += buffer.size();
+}
+
+/**
+ * @brief Starts a broadcast that spans several channels (QUIT, NICK).
+ * @return unsigned long A fresh epoch, to pass to every Channel::broadcast_message() of that broadcast
  *
- * @note IRC protocol uses ':' prefix for parameters containing spaces
- * @see IRC RFC 2812 for parameter format specifications
- * @see split_cmd() for complete command tokenization
+ * @details A member shared by several of those channels must hear the message once.
+ * Each client remembers the epoch of the last such broadcast that reached it,
+ * so the check costs one comparison and no allocation per recipient.
+ * Called with _lock held, like every other command path.
  */
-std::string Server::normalize_param(const std::string &s, bool flag)
+unsigned long Server::beginFanout()
 {
-	std::string result = s;
+	return ++_fanoutEpoch;
+}
 
-	//Remove spaces/tabs at the beginnin
-	size_t start = result.find_first_not_of(" \t\r\n");
-	if (start == std::string::npos)
-		return "";
+/**
+ * @brief Disconnects a slow consumer whose send queue went over its class limit.
+ * @param client The client that could not accept more replies
+ * @return void
+ *
+ * @details
+ * - Drops the queued replies so memory is released right away
+ * - Queues "ERROR :SendQ exceeded" (bypassing the limit), flushed before the client is closed
+ * - Flags the client as quitting; it is closed through ft_close() at the end of the loop iteration
+ * - Counts the event in ServerMetrics::sendqExceeded
+ *
+ * @note The client cannot be closed here: the caller may be iterating over channel members
+ */
+void Server::sendqExceeded(Client *client)
+{
+	std::cerr << RED << "SendQ exceeded on fd " << client->get_fd() << ", "
+		<< client->get_sendQueueBytes() << " bytes pending" << RESET << std::endl;
+	_metrics.sendqExceeded++;
+
+	client->dropQueuedOutput();
+	client->enqueueResponse(SharedBuffer(ERROR_SENDQ_EXCEEDED()), static_cast<size_t>(-1));
+	scheduleFlush(client);
+	scheduleClose(client);
+}
+
+/**
+ * @brief Prints the server-wide counters collected in ServerMetrics.
+ * @return void
+ */
+void Server::printMetrics() const
+{
+	std::cout << BLUE << "Metrics:" << std::endl
+		<< "  sendq exceeded disconnects: " << _metrics.sendqExceeded << std::endl
+		<< "  channel fanouts: " << _metrics.fanouts << " (" << _metrics.fanoutRecipients << " recipients, "
+		<< _metrics.fanoutBytesSerialized << " bytes serialized)" << std::endl;
+	if (_metrics.fanouts)
+		std::cout << "  per fanout: " << _metrics.fanoutRecipients / _metrics.fanouts << " recipients sharing 1 buffer of "
+			<< _metrics.fanoutBytesSerialized / _metrics.fanouts << " bytes" << std::endl;
+	std::cout << "  commands: " << _metrics.commands << ", replies queued: " << _metrics.repliesQueued
+		<< ", writev() calls: " << _metrics.flushSyscalls
+		<< ", syscalls saved: " << (_metrics.repliesQueued > _metrics.flushSyscalls ? _metrics.repliesQueued - _metrics.flushSyscalls : 0) << std::endl;
+	std::cout << "  bytes queued: " << _metrics.bytesQueued << " (" << _metrics.colorBytes << " of color codes, "
+		<< (_output == OUTPUT_WIRE ? "--wire" : "0 with --wire") << ")" << std::endl;
+	std::cout << "  dispatched: " << _metrics.commandsByCost[COST_LIGHT] << " light, " << _metrics.commandsByCost[COST_DIRECT] << " direct, "
+		<< _metrics.commandsByCost[COST_FANOUT] << " fanout, " << _metrics.unknownCommands << " unknown" << std::endl;
+	std::cout << "  reads: " << _metrics.reads << " recv() calls, " << _metrics.bytesRead << " bytes, read budget exhausted "
+		<< _metrics.readBudgetHits << " times, " << _metrics.linesTooLong << " lines over " << IRC_LINE_MAX << " bytes dropped" << std::endl;
+	std::cout << "  accepts: " << _metrics.accepts << " in " << _metrics.acceptTicks << " wakeups (max "
+		<< _metrics.acceptMaxPerTick << " per wakeup, cap hit " << _metrics.acceptCapHits << " times, "
+		<< _metrics.acceptEmfile << " shed on EMFILE)" << std::endl;
+	std::cout << "  clients: " << _clients.size() << " connected, " << _clients.capacity() << " slab slots" << std::endl;
+	size_t arenaBytes = 0;
+	for (size_t i = 0; i < _reactors.size(); i++)
+		arenaBytes += _reactors[i]->arena.get_reserved();
+	std::cout << "  command arenas: " << arenaBytes << " bytes reserved across " << _reactors.size() << " reactor(s)" << std::endl;
+	if (_metrics.commands)
+		std::cout << "  per command: " << static_cast<double>(_metrics.repliesQueued) / _metrics.commands << " replies, "
+			<< static_cast<double>(_metrics.flushSyscalls) / _metrics.commands << " writev() calls" << std::endl;
+	std::cout << RESET;
+}
+
+/**
+ * @brief Sends queued replies until the queue is empty or the socket would block.
+ * @param client The client whose queue is flushed (NULL is ignored)
+ * @return void
+ *
+ * @details
+ * - Up to FLUSH_MAX_IOVECS queued replies are gathered by each writev() call
+ * - Partial writes keep the unsent tail at the front of the queue
+ * - EAGAIN leaves the remaining bytes queued and enables write interest
+ * - Any other send() error flags the client as quitting; it is closed at the end of the loop iteration
+ *
+ * @note The client is never closed here, callers may still be iterating over channel members
+ */
+void Server::flushSendQueue(Client *client)
+{
+	if (!client)
+		return;
+
+	struct iovec iov[FLUSH_MAX_IOVECS];
+	while (client->hasPendingOutput())
+	{
+		int count = client->pendingIovecs(iov, FLUSH_MAX_IOVECS);
+		ssize_t sent = writev(client->get_fd(), iov, count);
+		_metrics.flushSyscalls++;
+		if (sent > 0)
+		{
+			client->consumeOutput(sent);
+			continue;
+		}
+		if (sent < 0 && errno == EINTR)
+			continue;
+		if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		std::cerr << RED << "Response writev() failed on fd " << client->get_fd() << RESET << std::endl;
+		scheduleClose(client);
+		break;
+	}
+	setWriteInterest(client, client->hasPendingOutput());
+}
+
+/**
+ * @brief Flags a client as quitting and lists it to be closed at the end of the current loop iteration.
+ * @param client The client to disconnect
+ * @return void
+ * @note Like scheduleFlush(), a client owned by another reactor is listed in that reactor's
+ *       pendingClose and closed by its own thread, after its last replies were flushed
+ * @see closeQuittingClients()
+ */
+void Server::scheduleClose(Client *client)
+{
+	if (client->get_isQuitting())
+		return;
+	client->set_isQuitting(true);
+	Reactor *owner = _reactors[client->get_reactor()];
+	owner->pendingClose.push_back(client->get_fd());
+	if (owner != _current)
+		wakeReactor(owner);
+}
+
+/**
+ * @brief Lists a client for the coalesced flush at the end of the current loop iteration.
+ * @param client The client that just got a reply queued
+ * @return void
+ * @note A client whose socket is already full (write interest enabled) waits for POLLOUT/EPOLLOUT instead
+ * @note A client owned by another reactor is listed in that reactor's pendingFlush, which is woken up
+ *       through its eventfd: sockets are only written by the thread that accepted them
+ */
+void Server::scheduleFlush(Client *client)
+{
+	if (client->get_flushScheduled() || client->get_wantsWrite())
+		return;
+	client->set_flushScheduled(true);
+	Reactor *owner = _reactors[client->get_reactor()];
+	owner->pendingFlush.push_back(client->get_fd());
+	if (owner != _current)
+		wakeReactor(owner);
+}
+
+/**
+ * @brief Lists a client whose read budget ran out, it is read again on the next loop iteration.
+ * @param client The client that still has unread data
+ * @return void
+ * @note Only needed with edge-triggered epoll: poll() keeps reporting POLLIN while data is left
+ * @note Called by the owner reactor without _lock (see receiveData()), pendingReads is only used by that thread
+ */
+void Server::scheduleRead(Client *client)
+{
+	if (_backend != BACKEND_EPOLL || client->get_readPending())
+		return;
+	client->set_readPending(true);
+	_reactors[client->get_reactor()]->pendingReads.push_back(client->get_fd());
+}
+
+/**
+ * @brief Wakes up a reactor blocked in epoll_wait() by writing to its eventfd.
+ * @param reactor The reactor to wake (ignored with the poll backend)
+ * @return void
+ * @note Must be called with _lock held; at most one wakeup is pending per reactor
+ */
+void Server::wakeReactor(Reactor *reactor)
+{
+#ifdef __linux__
+	if (reactor->wakeFd < 0 || reactor->wakePending)
+		return;
+	reactor->wakePending = true;
+	eventfd_write(reactor->wakeFd, 1);
+#else
+	(void)reactor;
+#endif
+}
 
-	//Remove spaces/tabs at the end
-	size_t end = result.find_last_not_of(" \t\r\n");
-	if (end != std::string::npos)
-		result =  result.substr(start, end - start + 1);
-	if(flag)
+/**
+ * @brief Flushes every client of the current reactor that got replies during this loop iteration, one writev() per client.
+ * @return void
+ *
+ * @details Replies are only queued while commands are handled; a JOIN (JOIN, 353, 366, 332)
+ * or a burst of PRIVMSGs to a channel therefore reaches each recipient in a single syscall.
+ * @note Called by both backends after all ready fds were handled and before quitting clients are closed
+ */
+void Server::flushPendingClients()
+{
+	std::vector<int> &pendingFlush = _current->pendingFlush;
+	for (size_t i = 0; i < pendingFlush.size(); i++)
 	{
-		if(!result.empty() && result[0] == ':') //Remove ':'
-			result.erase(result.begin());
+		Client *client = get_client(pendingFlush[i]);
+		if (!client || !client->get_flushScheduled() || client->get_reactor() != _current->index)
+			continue; //closed (or fd reused) during this iteration
+		client->set_flushScheduled(false);
+		flushSendQueue(client);
 	}
-	return result;
+	pendingFlush.clear();
 }
 
 /**
- * @brief Splits IRC command string into individual tokens for parsing.
- * @param cmd The complete IRC command string to split
- * @return std::vector<std::string> Vector of command tokens
+ * @brief Snapshots, as iovecs, the queued replies of the reactor's clients that can be written.
+ * @param reactor The current reactor
+ * @param writable Owned fds reported by EPOLLOUT
+ * @param writes Filled with one PendingWrite per client with replies
+ * @param iovecs Filled with the iovecs of those writes
+ * @return void
  *
- * @details Implements IRC command tokenization:
- * - Splits command by whitespace into individual tokens
- * - Handles parameters with spaces prefixed by ':'
- * - Preserves trailing parameters as single token
- * - Uses stringstream for efficient parsing
- * - Essential for IRC protocol command processing
+ * @details Called with _lock held; performWrites() then writes without it. The snapshotted replies
+ * stay at the front of each send queue (Client::_sendInFlight) until completeWrites() consumed them,
+ * so a sendq overflow on another reactor meanwhile cannot release bytes handed to writev().
+ */
+void Server::prepareWrites(Reactor *reactor, const std::vector<int> &writable, std::vector<PendingWrite> &writes, std::vector<struct iovec> &iovecs)
+{
+	writes.clear();
+	iovecs.clear();
+	std::vector<int> &pendingFlush = reactor->pendingFlush;
+	for (size_t i = 0; i < pendingFlush.size(); i++)
+	{
+		Client *client = get_client(pendingFlush[i]);
+		if (!client || !client->get_flushScheduled() || client->get_reactor() != reactor->index)
+			continue; //closed (or fd reused) during this iteration
+		client->set_flushScheduled(false);
+		prepareWrite(client, writes, iovecs);
+	}
+	pendingFlush.clear();
+	for (size_t i = 0; i < writable.size(); i++)
+	{
+		Client *client = get_client(writable[i]);
+		if (client && client->get_reactor() == reactor->index)
+			prepareWrite(client, writes, iovecs);
+	}
+}
+
+/**
+ * @brief Adds one client's queued replies, at most FLUSH_MAX_IOVECS of them, to a write batch.
+ * @note A client already in the batch, or without queued replies, is skipped
+ */
+void Server::prepareWrite(Client *client, std::vector<PendingWrite> &writes, std::vector<struct iovec> &iovecs)
+{
+	if (client->get_sendInFlight() > 0 || !client->hasPendingOutput())
+		return;
+	PendingWrite write;
+	write.client = client;
+	write.fd = client->get_fd();
+	write.firstIovec = iovecs.size();
+	iovecs.resize(write.firstIovec + FLUSH_MAX_IOVECS);
+	write.iovecCount = client->pendingIovecs(&iovecs[write.firstIovec], FLUSH_MAX_IOVECS);
+	iovecs.resize(write.firstIovec + write.iovecCount);
+	write.bytes = 0;
+	for (int i = 0; i < write.iovecCount; i++)
+		write.bytes += iovecs[write.firstIovec + i].iov_len;
+	write.sent = 0;
+	write.error = 0;
+	client->set_sendInFlight(write.iovecCount);
+	writes.push_back(write);
+}
+
+/**
+ * @brief Makes the writev() calls of a batch prepared by prepareWrites().
+ * @return void
+ * @note Runs without _lock: it only reads the snapshotted iovecs, whose buffers stay referenced
+ *       by the send queues until completeWrites()
+ */
+void Server::performWrites(std::vector<PendingWrite> &writes, std::vector<struct iovec> &iovecs)
+{
+	for (size_t i = 0; i < writes.size(); i++)
+	{
+		PendingWrite &write = writes[i];
+		do
+			write.sent = writev(write.fd, &iovecs[write.firstIovec], write.iovecCount);
+		while (write.sent < 0 && errno == EINTR);
+		write.error = (write.sent < 0) ? errno : 0;
+	}
+}
+
+/**
+ * @brief Applies the results of performWrites() to the send queues.
+ * @param writes The batch, cleared on return
+ * @return bool True if a client still has replies queued after a complete write,
+ *         it is listed in pendingFlush and the next loop iteration must not block
  *
- * @note IRC protocol format: COMMAND param1 param2 :trailing parameter
- * @note Trailing parameter (after ':') can contain spaces
- * @see normalize_param() for individual parameter cleanup
- * @see Server::parser() for command execution using parsed tokens
+ * @details Called with _lock held, like flushSendQueue():
+ * - Written bytes leave the front of the queue
+ * - EAGAIN, or a short write, leaves the rest queued and enables write interest
+ * - Any other writev() error flags the client as quitting
  */
-std::vector<std::string> Server::split_cmd(std::string &cmd)
+bool Server::completeWrites(std::vector<PendingWrite> &writes)
 {
-	std::vector<std::string> commands;
-	std::istringstream iss(cmd); //converts the string into an input stream so it can work with >>
-	std::string token;
-	while(iss >> token) //the >> operator reads until the first whitespace and stores it in the token variable
+	bool moreOutput = false;
+	for (size_t i = 0; i < writes.size(); i++)
 	{
-		if(token[0] == ':')
+		PendingWrite &write = writes[i];
+		Client *client = write.client;
+		client->set_sendInFlight(0);
+		_metrics.flushSyscalls++;
+		if (write.sent > 0)
+			client->consumeOutput(write.sent);
+		else if (write.error != EAGAIN && write.error != EWOULDBLOCK)
 		{
-			std::string rest;
-			std::getline(iss, rest);
-			token.erase(token.begin());
-			token = token + rest;
+			std::cerr << RED << "Response writev() failed on fd " << write.fd << RESET << std::endl;
+			scheduleClose(client);
+			continue;
+		}
+		if (static_cast<size_t>(write.sent) == write.bytes && client->hasPendingOutput())
+		{
+			setWriteInterest(client, false);
+			scheduleFlush(client);
+			moreOutput = true;
+			continue;
+		}
+		setWriteInterest(client, client->hasPendingOutput());
+	}
+	writes.clear();
+	return moreOutput;
+}
+
+/**
+ * @brief Adds the read counters a reactor collected without _lock to ServerMetrics.
+ * @param reactor The reactor, its counters are reset
+ * @return void
+ */
+void Server::addReadCounters(Reactor *reactor)
+{
+	_metrics.reads += reactor->reads;
+	_metrics.bytesRead += reactor->bytesRead;
+	_metrics.readBudgetHits += reactor->readBudgetHits;
+	reactor->reads = 0;
+	reactor->bytesRead = 0;
+	reactor->readBudgetHits = 0;
+}
+
+/**
+ * @brief Enables or disables write readiness notifications for a client socket.
+ * @param client The client to update
+ * @param enable True while the client has queued replies
+ * @return void
+ * @note Only touches poll/epoll when the state actually changes
+ */
+void Server::setWriteInterest(Client *client, bool enable)
+{
+	if (client->get_wantsWrite() == enable)
+		return;
+	client->set_wantsWrite(enable);
+
+#ifdef __linux__
+	if (_backend == BACKEND_EPOLL)
+	{
+		struct epoll_event ev;
+		memset(&ev, 0, sizeof(ev));
+		ev.events = EPOLLIN | EPOLLET;
+		if (enable)
+			ev.events |= EPOLLOUT;
+		ev.data.fd = client->get_fd();
+		epoll_ctl(_reactors[client->get_reactor()]->epollFd, EPOLL_CTL_MOD, client->get_fd(), &ev);
+		return;
+	}
+#endif
+	for (size_t i = 0; i < _fds.size(); i++)
+	{
+		if (_fds[i].fd == client->get_fd())
+		{
+			_fds[i].events = enable ? (POLLIN | POLLOUT) : POLLIN;
+			break;
 		}
-		commands.push_back(token);
-		token.clear();
 	}
-	return commands;
 }
 
 /**
@@ -137,7 +536,8 @@ std::vector<std::string> Server::split_cmd(std::string &cmd)
  * - Removes client from all joined channels
  * - Removes client from server client list
  * - Removes file descriptor from poll() monitoring
- * - Closes socket connection
+ * - Closes socket connection (unsent queued replies are discarded)
+ * - Logs the send queue depth and high-water mark of the connection
  * - Ensures no resource leaks on client disconnect
  *
  * @note Called when client disconnects or encounters errors
@@ -147,9 +547,13 @@ std::vector<std::string> Server::split_cmd(std::string &cmd)
  */
 void Server::ft_close(int Fd)
 {
+	Client *client = get_client(Fd);
+	if (client && client->get_sendQueueHighWater() > 0)
+		std::cout << YELLOW << "Client fd " << Fd << " sendq: " << client->get_sendQueueBytes()
+			<< " bytes pending, high-water " << client->get_sendQueueHighWater() << " bytes" << RESET << std::endl;
 	RemoveClientFromChannel(Fd);
+	RemoveFd(Fd); //before RemoveClient(): the client tells which reactor's epoll watches Fd
 	RemoveClient(Fd);
-	RemoveFd(Fd);
 	close(Fd);
 }
 
@@ -158,10 +562,11 @@ void Server::ft_close(int Fd)
  * @param clientFd The file descriptor of the client to remove
  * @return void
  *
- * @details Searches and removes client from _clients vector:
- * - Iterates through client list to find matching file descriptor
- * - Removes client object from vector when found
- * - Breaks after removal to avoid iterator invalidation
+ * @details Removes the client from the _clients slab in O(1):
+ * - Finds its handle through the _clientSlots fd index
+ * - Frees its nickname in the _nicks registry
+ * - Releases its slab slot, no other client is moved, and clears the fd slot
+ *   (handles kept elsewhere become stale)
  * - Part of comprehensive client cleanup process
  *
  * @note Called during client disconnection cleanup
@@ -169,14 +574,13 @@ void Server::ft_close(int Fd)
  */
 void Server::RemoveClient(int clientFd)
 {
-	for (std::vector<Client>::iterator it = _clients.begin(); it != _clients.end(); it++)
-	{
-		if (it->get_fd() == clientFd)
-		{
-			_clients.erase(it);
-			break;
-		}
-	}
+	Client *client = get_client(clientFd);
+	if (!client)
+		return;
+	_nicks.remove(client->get_nickname(), clientFd);
+	_reactors[client->get_reactor()]->clients[clientFd] = NULL;
+	_clients.release(_clientSlots[clientFd]);
+	_clientSlots[clientFd] = ClientHandle();
 }
 
 /**
@@ -185,10 +589,10 @@ void Server::RemoveClient(int clientFd)
  * @return void
  *
  * @details Manages poll() file descriptor cleanup:
- * - Searches _fds vector for matching file descriptor
- * - Removes pollfd structure from monitoring list
- * - Resets listening socket if it was the removed descriptor
- * - Prevents poll() from monitoring closed sockets
+ * - With epoll, removes the descriptor from the reactor's interest list; client sockets are
+ *   not in _fds then (see addClient()), so a disconnect costs no scan of the connections
+ * - With poll, searches _fds for the descriptor and removes its pollfd structure
+ * - Prevents poll()/epoll from monitoring closed sockets
  *
  * @note Essential for proper poll() operation after client disconnect
  * @see ft_close() for complete disconnection process
@@ -196,6 +600,14 @@ void Server::RemoveClient(int clientFd)
  */
 void Server::RemoveFd(int Fd)
 {
+#ifdef __linux__
+	Client *client = get_client(Fd);
+	if (_backend == BACKEND_EPOLL && client)
+	{
+		epoll_ctl(_reactors[client->get_reactor()]->epollFd, EPOLL_CTL_DEL, Fd, NULL); //must happen before close(), the kernel drops closed fds on its own
+		return;
+	}
+#endif
 	for (std::vector<struct pollfd>::iterator it = _fds.begin(); it != _fds.end(); it++)
 	{
 		if (it->fd == Fd)
@@ -207,35 +619,102 @@ void Server::RemoveFd(int Fd)
 }
 
 /**
- * @brief Removes client from all channels and broadcasts QUIT message.
+ * @brief Registers a socket in the epoll interest list of a reactor (no-op with the poll backend).
+ * @param reactor The reactor whose epoll instance watches the socket
+ * @param fd The socket to monitor for incoming data
+ * @param edgeTriggered True to request EPOLLET notifications (the reader must drain until EAGAIN)
+ * @return void
+ *
+ * @throws std::runtime_error If epoll_ctl() fails
+ * @note With poll() the _fds vector already is the interest list, so nothing else is needed
+ * @see RemoveFd() for the matching removal
+ */
+void Server::watchFd(Reactor *reactor, int fd, bool edgeTriggered)
+{
+#ifdef __linux__
+	if (_backend != BACKEND_EPOLL)
+		return;
+
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	if (edgeTriggered)
+		ev.events |= EPOLLET;
+	ev.data.fd = fd;
+	if (epoll_ctl(reactor->epollFd, EPOLL_CTL_ADD, fd, &ev) < 0)
+		throw(std::runtime_error("Failed to register socket in epoll"));
+#else
+	(void)reactor;
+	(void)fd;
+	(void)edgeTriggered;
+#endif
+}
+
+/**
+ * @brief Closes every client that was flagged by QUIT during the current loop iteration.
+ * @return void
+ *
+ * @note Called once per event loop iteration by both backends, after all ready fds were handled
+ * @note Only walks the current reactor's pendingClose list (see scheduleClose()), not every client
+ * @note Only the clients of the current reactor are closed: a client of another reactor may still
+ *       have its final "ERROR" reply listed in that reactor's pendingFlush
+ * @see Server::QUIT() for the flagging of unregistered clients
+ */
+void Server::closeQuittingClients()
+{
+	std::vector<int> closing;
+	closing.swap(_current->pendingClose);
+	closeClients(closing);
+}
+
+/**
+ * @brief Closes the clients of a pendingClose list that are still flagged as quitting.
+ * @param closing Fds swapped out of the current reactor's pendingClose, cleared on return
+ * @return void
+ * @note The epoll reactors swap pendingClose before their unlocked writes, so a client flagged
+ *       during the writes keeps its last replies (e.g. "ERROR :SendQ exceeded") for the next flush
+ */
+void Server::closeClients(std::vector<int> &closing)
+{
+	for (size_t i = 0; i < closing.size(); i++)
+	{
+		Client *client = get_client(closing[i]);
+		if (!client || !client->get_isQuitting() || client->get_reactor() != _current->index)
+			continue; //already closed (or fd reused) since it was listed
+		ft_close(closing[i]);
+		std::cout << YELLOW << "Client fd " << closing[i] << " disconnected\n" << RESET;
+	}
+	closing.clear();
+}
+
+/**
+ * @brief Removes client from all channels, deleting the ones it leaves empty.
  * @param fd The file descriptor of the client to remove from channels
  * @return void
  *
- * @details Handles comprehensive channel cleanup on client disconnect:
- * - Iterates through all server channels
- * - Removes client from regular member and admin lists
- * - Deletes empty channels after client removal
- * - Broadcasts QUIT message to remaining channel members
- * - Maintains channel integrity after client departures
+ * @details Handles channel cleanup on client disconnect:
+ * - Iterates through the client's joined channels only (reverse index kept by Channel)
+ * - Removes the client's membership, whatever its status
+ * - Deletes empty channels after client removal (erasing from the directory moves no other channel)
  *
- * @note QUIT message format follows IRC protocol specification
- * @note Empty channels are automatically cleaned up
+ * @note Sends nothing: QUIT() broadcasts its message before it calls ft_close(), a connection
+ *       that drops without a QUIT is not announced to the remaining members
  * @see ft_close() for complete disconnection process
- * @see Channel::remove_client() and Channel::remove_admin() for member removal
+ * @see Channel::remove_member() for member removal
  */
 void Server::RemoveClientFromChannel(int fd)
 {
-	for (size_t i = 0; i < this->_channels.size(); i++)
+	Client *client = get_client(fd);
+	if (!client)
+		return;
+	std::vector<Channel*> joined = client->get_joinedChannels(); //remove_member() shrinks the client's list
+	for (size_t i = 0; i < joined.size(); i++)
 	{
-		if (_channels[i].get_clientByFd(fd))
-			_channels[i].remove_client(fd);
-		else if (_channels[i].get_adminByFd(fd))
-			_channels[i].remove_admin(fd);
-		if (_channels[i].get_totalUsers() == 0)
+		joined[i]->remove_member(fd);
+		if (joined[i]->get_totalUsers() == 0)
 		{
-			_channels.erase(_channels.begin() + i);
-			i--;
-			continue;
+			std::string channel_name = joined[i]->get_name();
+			RemoveChannel(channel_name);
 		}
 	}
 }
@@ -245,10 +724,9 @@ void Server::RemoveClientFromChannel(int fd)
  * @param name The name of the channel to remove
  * @return void
  *
- * @details Searches and removes channel from _channels vector:
- * - Iterates through channel list to find matching name
- * - Removes channel object from vector when found
- * - Returns immediately after removal
+ * @details Removes the channel from the _channels directory in O(1):
+ * - Looks the name up under the RFC 1459 case mapping
+ * - Deletes the channel and erases its entry, no other channel is moved or copied
  * - Used for channel cleanup when channels become empty
  *
  * @note Called when channels have no remaining members
@@ -256,12 +734,9 @@ void Server::RemoveClientFromChannel(int fd)
  */
 void Server::RemoveChannel(std::string &name)
 {
-	for (std::vector<Channel>::iterator it = _channels.begin(); it != _channels.end(); ++it)
-	{
-		if (it->get_name() == name)
-		{
-			_channels.erase(it);
-			return;
-		}
-	}
+	ChannelMap::iterator it = _channels.find(name);
+	if (it == _channels.end())
+		return;
+	delete it->second;
+	_channels.erase(it);
 }